@@ -0,0 +1,142 @@
+#include <string.h>
+#include <sys/mman.h>
+
+#include "arena.hpp"
+#include "errors.hpp"
+
+namespace holeyc{
+
+thread_local Arena * Arena::theCurrent = nullptr;
+
+static const size_t HUGE_PAGE = size_t(2) << 20;
+static const size_t MAX_CHUNK = size_t(64) << 20;
+
+Arena::Arena()
+: myCur(nullptr), myEnd(nullptr), myChunks(nullptr),
+  myNextChunkSize(HUGE_PAGE), myFullBytes(0), myNodeCount(0){ }
+
+Arena::~Arena(){
+	release();
+}
+
+Arena * Arena::current(){
+	if (theCurrent == nullptr){
+		throw new InternalError("No arena to allocate from");
+	}
+	return theCurrent;
+}
+
+//Map len bytes (a multiple of HUGE_PAGE) aligned to a huge 
+// page boundary, by over-mapping and trimming the ends
+static char * mapChunk(size_t len){
+	size_t over = len + HUGE_PAGE;
+	void * region = mmap(nullptr, over, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (region == MAP_FAILED){ return nullptr; }
+	char * start = static_cast<char *>(region);
+	size_t addr = reinterpret_cast<size_t>(start);
+	size_t head = (HUGE_PAGE - (addr & (HUGE_PAGE - 1))) 
+		& (HUGE_PAGE - 1);
+	if (head > 0){ munmap(start, head); }
+	size_t tail = over - head - len;
+	if (tail > 0){ munmap(start + head + len, tail); }
+	char * chunk = start + head;
+#ifdef MADV_HUGEPAGE
+	madvise(chunk, len, MADV_HUGEPAGE);
+#endif
+	return chunk;
+}
+
+void * Arena::allocateSlow(size_t size, size_t align){
+	size_t need = size + align + sizeof(Chunk);
+	size_t len = myNextChunkSize;
+	while (len < need){ len *= 2; }
+	if (myNextChunkSize < MAX_CHUNK){ myNextChunkSize *= 2; }
+
+	char * mem = mapChunk(len);
+	if (mem == nullptr){ throw std::bad_alloc(); }
+
+	if (myChunks != nullptr){
+		myFullBytes += static_cast<size_t>(myCur 
+			- reinterpret_cast<char *>(myChunks + 1));
+	}
+	Chunk * chunk = reinterpret_cast<Chunk *>(mem);
+	chunk->prev = myChunks;
+	chunk->size = len;
+	myChunks = chunk;
+	myCur = reinterpret_cast<char *>(chunk + 1);
+	myEnd = mem + len;
+	return allocate(size, align);
+}
+
+const char * Arena::copyString(const char * text, size_t len){
+	char * res = static_cast<char *>(allocate(len + 1, 1));
+	memcpy(res, text, len);
+	res[len] = '\0';
+	return res;
+}
+
+void Arena::release(){
+	Chunk * chunk = myChunks;
+	while (chunk != nullptr){
+		Chunk * prev = chunk->prev;
+		munmap(chunk, chunk->size);
+		chunk = prev;
+	}
+	myChunks = nullptr;
+	myCur = myEnd = nullptr;
+	myNextChunkSize = HUGE_PAGE;
+	myFullBytes = 0;
+	myNodeCount = 0;
+}
+
+Arena::Mark Arena::mark() const {
+	Mark m;
+	m.chunk = myChunks;
+	m.cur = myCur;
+	m.end = myEnd;
+	m.fullBytes = myFullBytes;
+	m.nodeCount = myNodeCount;
+	return m;
+}
+
+void Arena::rewind(const Mark& m){
+	Chunk * markChunk = static_cast<Chunk *>(m.chunk);
+	Chunk * spare = nullptr;
+	while (myChunks != markChunk){
+		Chunk * chunk = myChunks;
+		myChunks = chunk->prev;
+		if (spare == nullptr){
+			spare = chunk;
+		} else {
+			munmap(chunk, chunk->size);
+		}
+	}
+	myNodeCount = m.nodeCount;
+	if (spare == nullptr){
+		myCur = m.cur;
+		myEnd = m.end;
+		myFullBytes = m.fullBytes;
+		return;
+	}
+
+	//Carry on in the spare chunk, leaving the rest of the
+	// mark's chunk unused
+	myFullBytes = m.fullBytes;
+	if (markChunk != nullptr){
+		myFullBytes += static_cast<size_t>(m.cur 
+			- reinterpret_cast<char *>(markChunk + 1));
+	}
+	spare->prev = markChunk;
+	myChunks = spare;
+	myCur = reinterpret_cast<char *>(spare + 1);
+	myEnd = reinterpret_cast<char *>(spare) + spare->size;
+}
+
+size_t Arena::bytesUsed() const {
+	if (myChunks == nullptr){ return 0; }
+	return myFullBytes + static_cast<size_t>(myCur 
+		- reinterpret_cast<const char *>(myChunks + 1));
+}
+
+}
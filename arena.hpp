@@ -0,0 +1,205 @@
+#ifndef HOLEYC_ARENA_HPP
+#define HOLEYC_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace holeyc{
+
+//A bump allocator for everything that lives as long as a
+// compilation: AST nodes, their child lists, semantic
+// symbols and scope tables. Allocation is a pointer bump
+// into a large chunk of memory; nothing is ever freed
+// individually, and destructors are not run. Destroying
+// (or releasing) the arena unmaps its chunks, which costs
+// the same however many objects were allocated.
+//
+//Chunks are 2MB-aligned and advised as huge pages, so the
+// tree walks touch few TLB entries.
+class Arena{
+public:
+	Arena();
+	~Arena();
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	void * allocate(size_t size, 
+	  size_t align = alignof(std::max_align_t)){
+		size_t pad = (align - (reinterpret_cast<size_t>(myCur) 
+			& (align - 1))) & (align - 1);
+		if (size + pad > static_cast<size_t>(myEnd - myCur)){
+			return allocateSlow(size, align);
+		}
+		char * res = myCur + pad;
+		myCur = res + size;
+		return res;
+	}
+
+	//Construct a T in the arena
+	template <typename T, typename... Args>
+	T * make(Args&&... args){
+		void * mem = allocate(sizeof(T), alignof(T));
+		return new (mem) T(std::forward<Args>(args)...);
+	}
+
+	//Copy len bytes of text into the arena, followed by a NUL
+	const char * copyString(const char * text, size_t len);
+
+	//Free everything allocated so far
+	void release();
+
+	//A point in the arena's history to rewind to
+	class Mark{
+	private:
+		friend class Arena;
+		void * chunk;
+		char * cur;
+		char * end;
+		size_t fullBytes;
+		uint32_t nodeCount;
+	};
+	Mark mark() const;
+	//Free everything allocated since m was taken (so m must
+	// not itself have been freed by an earlier rewind). The
+	// newest chunk is kept for reuse, so rewinding over and
+	// over to the same point does not map a chunk each time.
+	void rewind(const Mark& m);
+
+	size_t bytesUsed() const;
+
+	//AST nodes are numbered densely, per arena, as they are
+	// built, so analyses can keep their per-node results in
+	// flat arrays (see NodeMap)
+	uint32_t newNodeID(){ return myNodeCount++; }
+	size_t nodeCount() const { return myNodeCount; }
+
+	//The arena that node allocations on this thread go to.
+	// Throws if no ArenaScope is active.
+	static Arena * current();
+private:
+	friend class ArenaScope;
+	struct Chunk{
+		Chunk * prev;
+		size_t size;
+	};
+	void * allocateSlow(size_t size, size_t align);
+
+	char * myCur;
+	char * myEnd;
+	Chunk * myChunks;
+	size_t myNextChunkSize;
+	size_t myFullBytes;
+	uint32_t myNodeCount;
+
+	static thread_local Arena * theCurrent;
+};
+
+//Makes arena the current arena for this thread for as long
+// as the ArenaScope lives
+class ArenaScope{
+public:
+	ArenaScope(Arena * arena) : myPrev(Arena::theCurrent){
+		Arena::theCurrent = arena;
+	}
+	~ArenaScope(){ Arena::theCurrent = myPrev; }
+private:
+	Arena * myPrev;
+};
+
+//Standard allocator over an arena, for containers that hang
+// off arena objects. Deallocation does nothing; the memory
+// goes when the arena does.
+template <typename T>
+class ArenaAllocator{
+public:
+	using value_type = T;
+
+	ArenaAllocator() : myArena(Arena::current()){ }
+	ArenaAllocator(Arena * arena) : myArena(arena){ }
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other)
+	: myArena(other.arena()){ }
+
+	T * allocate(size_t n){
+		return static_cast<T *>(
+			myArena->allocate(n * sizeof(T), alignof(T)));
+	}
+	void deallocate(T *, size_t){ }
+
+	Arena * arena() const { return myArena; }
+	template <typename U>
+	bool operator==(const ArenaAllocator<U>& other) const {
+		return myArena == other.arena();
+	}
+	template <typename U>
+	bool operator!=(const ArenaAllocator<U>& other) const {
+		return myArena != other.arena();
+	}
+private:
+	Arena * myArena;
+};
+
+//A view of a contiguous array of Ts in an arena. This is
+// how AST nodes hold their children, so walking the children
+// is a linear scan rather than a pointer chase per child.
+template <typename T>
+class Span{
+public:
+	Span() : myData(nullptr), mySize(0){ }
+	Span(T * data, size_t size) : myData(data), mySize(size){ }
+	T * begin() const { return myData; }
+	T * end() const { return myData + mySize; }
+	size_t size() const { return mySize; }
+	bool empty() const { return mySize == 0; }
+	T& operator[](size_t i) const { return myData[i]; }
+private:
+	T * myData;
+	size_t mySize;
+};
+
+//A growable array in the current arena, used by the parser
+// to collect a list of children before handing the finished
+// Span to a node. It starts small and doubles; outgrown
+// arrays are left behind in the arena, which bounds the
+// waste by the size of the final array.
+template <typename T>
+class ArenaVector{
+	static_assert(std::is_trivially_copyable<T>::value,
+		"ArenaVector elements are moved with memcpy");
+public:
+	ArenaVector() : myData(nullptr), mySize(0), myCapacity(0){ }
+	static void * operator new(size_t size){
+		return Arena::current()->allocate(size);
+	}
+	static void operator delete(void *){ }
+
+	void push_back(T elt){
+		if (mySize == myCapacity){ grow(); }
+		myData[mySize++] = elt;
+	}
+	size_t size() const { return mySize; }
+	Span<T> span() const { return Span<T>(myData, mySize); }
+private:
+	void grow(){
+		size_t capacity = myCapacity == 0 ? 4 : myCapacity * 2;
+		T * data = static_cast<T *>(Arena::current()->allocate(
+			capacity * sizeof(T), alignof(T)));
+		if (mySize > 0){
+			memcpy(data, myData, mySize * sizeof(T));
+		}
+		myData = data;
+		myCapacity = capacity;
+	}
+
+	T * myData;
+	size_t mySize;
+	size_t myCapacity;
+};
+
+}
+
+#endif
@@ -4,8 +4,11 @@
 #include <ostream>
 #include <sstream>
 #include <string.h>
-#include <list>
+#include "arena.hpp"
+#include "out_buffer.hpp"
+#include "source_manager.hpp"
 #include "tokens.hpp"
+#include "intern_table.hpp"
 #include "types.hpp"
 
 namespace holeyc {
@@ -33,99 +36,115 @@ class ExpNode;
 class LValNode;
 class IDNode;
 
+//The concrete class of an ASTNode. Passes switch on this (see
+// ASTVisitor in ast_visitor.hpp) rather than calling virtual
+// methods of the nodes, so a new pass is a new visitor and no
+// class here needs to change.
+enum class NodeKind : uint8_t {
+	PROGRAM,
+	VAR_DECL, FORMAL_DECL, FN_DECL,
+	ASSIGN_STMT, FROM_CONSOLE, TO_CONSOLE, POST_DEC, POST_INC,
+	IF, IF_ELSE, WHILE, RETURN, CALL_STMT,
+	ID, REF, DEREF, INDEX,
+	CALL_EXP, ASSIGN_EXP,
+	PLUS, MINUS, TIMES, DIVIDE, AND, OR,
+	EQUALS, NOT_EQUALS, LESS, LESS_EQ, GREATER, GREATER_EQ,
+	NEG, NOT,
+	INT_LIT, STR_LIT, CHAR_LIT, NULLPTR_LIT, TRUE_LIT, FALSE_LIT,
+	VOID_TYPE, INT_TYPE, BOOL_TYPE, CHAR_TYPE,
+};
+
 class ASTNode{
 public:
-	ASTNode(size_t lineIn, size_t colIn)
-	: l(lineIn), c(colIn){ }
-	virtual void unparse(std::ostream&, int) = 0;
-	size_t line() const { return this->l; }
-	size_t col() const { return this->c; }
+	//offset is where the node's first token starts
+	ASTNode(NodeKind kindIn, size_t offset)
+	: mySourceOffset(static_cast<uint32_t>(offset)),
+	  myID(Arena::current()->newNodeID()), myKind(kindIn){ }
+	//Nodes live in the current Arena and are freed with it
+	static void * operator new(size_t size){
+		return Arena::current()->allocate(size);
+	}
+	static void operator delete(void *){ }
+	NodeKind kind() const { return myKind; }
+	void unparse(OutBuffer& out, int indent);
+	size_t offset() const { return mySourceOffset; }
+	//Looked up in the current SourceManager
+	size_t line() const {
+		return SourceManager::current()->line(mySourceOffset);
+	}
+	size_t col() const {
+		return SourceManager::current()->col(mySourceOffset);
+	}
+	//Dense, in order of construction; the index of this
+	// node's entries in a NodeMap
+	uint32_t nodeID() const { return myID; }
 	std::string pos(){
 		return "[" + std::to_string(line()) + ","
 			+ std::to_string(col()) + "]";
 	}
-	virtual bool nameAnalysis(SymbolTable *) = 0;
-	//Note that there is no ASTNode::typeAnalysis. To allow
-	// for different type signatures, type analysis is 
-	// implemented as needed in various subclasses
 private:
-	size_t l;
-	size_t c;
+	uint32_t mySourceOffset;
+	uint32_t myID;
+	NodeKind myKind;
 };
 
 class ProgramNode : public ASTNode{
 public:
-	ProgramNode(std::list<DeclNode *> * globalsIn)
-	: ASTNode(1,1), myGlobals(globalsIn){}
-	void unparse(std::ostream&, int) override;
-	virtual bool nameAnalysis(SymbolTable *) override;
-	virtual void typeAnalysis(TypeAnalysis *);
+	ProgramNode(Span<DeclNode *> globalsIn)
+	: ASTNode(NodeKind::PROGRAM, 0), myGlobals(globalsIn){}
+	Span<DeclNode *> getGlobals() const { return myGlobals; }
+	bool nameAnalysis(SymbolTable *);
+	void typeAnalysis(TypeAnalysis *);
 private:
-	std::list<DeclNode *> * myGlobals;
+	Span<DeclNode *> myGlobals;
 };
 
 class ExpNode : public ASTNode{
 public:
-	ExpNode(size_t lIn, size_t cIn) : ASTNode(lIn, cIn){ }
-	virtual void unparseNested(std::ostream& out);
-	virtual void unparse(std::ostream& out, int indent) override = 0;
-	virtual bool nameAnalysis(SymbolTable * symTab) override = 0;
-	virtual void typeAnalysis(TypeAnalysis *);
+	ExpNode(NodeKind kind, size_t offset) : ASTNode(kind, offset){ }
 };
 
 class LValNode : public ExpNode{
 public:
-	LValNode(size_t lIn, size_t cIn) : ExpNode(lIn, cIn){}
-	void unparse(std::ostream& out, int indent) override = 0;
-	void unparseNested(std::ostream& out) override;
-	void attachSymbol(SemSymbol * symbolIn) { } 
-	bool nameAnalysis(SymbolTable * symTab) override { return false; }
+	LValNode(NodeKind kind, size_t offset) : ExpNode(kind, offset){}
 };
 
 class IDNode : public LValNode{
 public:
-	IDNode(size_t lIn, size_t cIn, std::string nameIn)
-	: LValNode(lIn, cIn), name(nameIn){}
-	std::string getName(){ return name; }
-	void unparse(std::ostream& out, int indent) override;
-	void attachSymbol(SemSymbol * symbolIn);
-	SemSymbol * getSymbol() const { return mySymbol; }
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	IDNode(size_t offset, NameID nameIn)
+	: LValNode(NodeKind::ID, offset), name(nameIn){}
+	NameID getNameID() const { return name; }
+	const std::string& getName() const {
+		return InternTable::global()->name(name);
+	}
 private:
-	std::string name;
-	SemSymbol * mySymbol = nullptr;
+	NameID name;
 };
 
 class RefNode : public LValNode{
 public:
-	RefNode(size_t l, size_t c, IDNode * id)
-	: LValNode(l, c), myID(id){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual bool nameAnalysis(SymbolTable *) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	RefNode(size_t offset, IDNode * id)
+	: LValNode(NodeKind::REF, offset), myID(id){ }
+	IDNode * ID() const { return myID; }
 private:
 	IDNode * myID;
 };
 
 class DerefNode : public LValNode{
 public:
-	DerefNode(size_t l, size_t c, IDNode * id)
-	: LValNode(l, c), myID(id){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual bool nameAnalysis(SymbolTable *) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	DerefNode(size_t offset, IDNode * id)
+	: LValNode(NodeKind::DEREF, offset), myID(id){ }
+	IDNode * ID() const { return myID; }
 private:
 	IDNode * myID;
 };
 
 class IndexNode : public LValNode{
 public:
-	IndexNode(size_t l, size_t c, IDNode * id, ExpNode * offset)
-	: LValNode(l, c), myBase(id), myOffset(offset){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	IndexNode(size_t offset, IDNode * id, ExpNode * index)
+	: LValNode(NodeKind::INDEX, offset), myBase(id), myOffset(index){ }
+	IDNode * getBase() const { return myBase; }
+	ExpNode * getIndex() const { return myOffset; }
 private:
 	IDNode * myBase;
 	ExpNode * myOffset;
@@ -134,45 +153,40 @@ private:
 
 class TypeNode : public ASTNode{
 public:
-	TypeNode(size_t l, size_t c) : ASTNode(l, c){ }
-	void unparse(std::ostream&, int) override = 0;
-	virtual DataType * getType() = 0;
-	virtual bool nameAnalysis(SymbolTable *) override;
+	TypeNode(NodeKind kind, size_t offset, bool isPtrIn)
+	: ASTNode(kind, offset), myIsPtr(isPtrIn){ }
+	bool isPtr() const { return myIsPtr; }
+	DataType * getType();
+private:
+	const bool myIsPtr;
 };
 
 class CharTypeNode : public TypeNode{
 public:
-	CharTypeNode(size_t lIn, size_t cIn, bool isPtrIn)
-	: TypeNode(lIn, cIn), isPtr(isPtrIn){}
-	void unparse(std::ostream& out, int indent) override;
-	virtual DataType * getType() override;
-private:
-	bool isPtr;
+	CharTypeNode(size_t offset, bool isPtrIn)
+	: TypeNode(NodeKind::CHAR_TYPE, offset, isPtrIn){}
 };
 
 class StmtNode : public ASTNode{
 public:
-	StmtNode(size_t lIn, size_t cIn) : ASTNode(lIn, cIn){ }
-	virtual void unparse(std::ostream& out, int indent) override = 0;
-	virtual void typeAnalysis(TypeAnalysis *, TypeNode *);
+	StmtNode(NodeKind kind, size_t offset) : ASTNode(kind, offset){ }
 };
 
 class DeclNode : public StmtNode{
 public:
-	DeclNode(size_t l, size_t c) : StmtNode(l, c){ }
-	void unparse(std::ostream& out, int indent) override =0;
-	virtual void typeAnalysis(TypeAnalysis * ,TypeNode *) override;
+	DeclNode(NodeKind kind, size_t offset) : StmtNode(kind, offset){ }
 };
 
 class VarDeclNode : public DeclNode{
 public:
-	VarDeclNode(size_t lIn, size_t cIn, TypeNode * typeIn, IDNode * IDIn)
-	: DeclNode(lIn, cIn), myType(typeIn), myID(IDIn){ }
-	void unparse(std::ostream& out, int indent) override;
+	VarDeclNode(size_t offset, TypeNode * typeIn, IDNode * IDIn)
+	: VarDeclNode(NodeKind::VAR_DECL, offset, typeIn, IDIn){ }
 	IDNode * ID(){ return myID; }
 	TypeNode * getTypeNode(){ return myType; }
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *, TypeNode *) override;
+protected:
+	VarDeclNode(NodeKind kind, size_t offset,
+	  TypeNode * typeIn, IDNode * IDIn)
+	: DeclNode(kind, offset), myType(typeIn), myID(IDIn){ }
 private:
 	TypeNode * myType;
 	IDNode * myID;
@@ -180,163 +194,148 @@ private:
 
 class FormalDeclNode : public VarDeclNode{
 public:
-	FormalDeclNode(size_t lIn, size_t cIn, TypeNode * type, IDNode * id) 
-	: VarDeclNode(lIn, cIn, type, id){ }
-	void unparse(std::ostream& out, int indent) override;
+	FormalDeclNode(size_t offset, TypeNode * type, IDNode * id) 
+	: VarDeclNode(NodeKind::FORMAL_DECL, offset, type, id){ }
 };
 
 class FnDeclNode : public DeclNode{
 public:
-	FnDeclNode(size_t lIn, size_t cIn, 
+	FnDeclNode(size_t offset, 
 	  TypeNode * retTypeIn, IDNode * idIn,
-	  std::list<FormalDeclNode *> * formalsIn,
-	  std::list<StmtNode *> * bodyIn)
-	: DeclNode(lIn, cIn), 
+	  Span<FormalDeclNode *> formalsIn,
+	  Span<StmtNode *> bodyIn)
+	: DeclNode(NodeKind::FN_DECL, offset), 
 	  myID(idIn), myRetType(retTypeIn),
 	  myFormals(formalsIn), myBody(bodyIn){ }
 	IDNode * ID() const { return myID; }
-	std::list<FormalDeclNode *> * getFormals() const{
+	Span<FormalDeclNode *> getFormals() const{
 		return myFormals;
 	}
-	virtual TypeNode * getRetTypeNode() { 
+	TypeNode * getRetTypeNode() const { 
 		return myRetType;
 	}
-	void unparse(std::ostream& out, int indent) override;
-	virtual bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *, TypeNode *) override;
+	Span<StmtNode *> getBody() const { return myBody; }
 private:
 	IDNode * myID;
 	TypeNode * myRetType;
-	std::list<FormalDeclNode *> * myFormals;
-	std::list<StmtNode *> * myBody;
+	Span<FormalDeclNode *> myFormals;
+	Span<StmtNode *> myBody;
 };
 
 class AssignStmtNode : public StmtNode{
 public:
-	AssignStmtNode(size_t l, size_t c, AssignExpNode * expIn)
-	: StmtNode(l, c), myExp(expIn){ }
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *, TypeNode *) override;
+	AssignStmtNode(size_t offset, AssignExpNode * expIn)
+	: StmtNode(NodeKind::ASSIGN_STMT, offset), myExp(expIn){ }
+	AssignExpNode * getExp() const { return myExp; }
 private:
 	AssignExpNode * myExp;
 };
 
 class FromConsoleStmtNode : public StmtNode{
 public:
-	FromConsoleStmtNode(size_t l, size_t c, LValNode * dstIn)
-	: StmtNode(l, c), myDst(dstIn){ }
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *, TypeNode *) override;
+	FromConsoleStmtNode(size_t offset, LValNode * dstIn)
+	: StmtNode(NodeKind::FROM_CONSOLE, offset), myDst(dstIn){ }
+	LValNode * getDst() const { return myDst; }
 private:
 	LValNode * myDst;
 };
 
 class ToConsoleStmtNode : public StmtNode{
 public:
-	ToConsoleStmtNode(size_t l, size_t c, ExpNode * srcIn)
-	: StmtNode(l, c), mySrc(srcIn){ }
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *, TypeNode *) override;
+	ToConsoleStmtNode(size_t offset, ExpNode * srcIn)
+	: StmtNode(NodeKind::TO_CONSOLE, offset), mySrc(srcIn){ }
+	ExpNode * getSrc() const { return mySrc; }
 private:
 	ExpNode * mySrc;
 };
 
 class PostDecStmtNode : public StmtNode{
 public:
-	PostDecStmtNode(size_t l, size_t c, LValNode * lvalIn)
-	: StmtNode(l, c), myLVal(lvalIn){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *, TypeNode *) override;
+	PostDecStmtNode(size_t offset, LValNode * lvalIn)
+	: StmtNode(NodeKind::POST_DEC, offset), myLVal(lvalIn){ }
+	LValNode * getLVal() const { return myLVal; }
 private:
 	LValNode * myLVal;
 };
 
 class PostIncStmtNode : public StmtNode{
 public:
-	PostIncStmtNode(size_t l, size_t c, LValNode * lvalIn)
-	: StmtNode(l, c), myLVal(lvalIn){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *, TypeNode *) override;
+	PostIncStmtNode(size_t offset, LValNode * lvalIn)
+	: StmtNode(NodeKind::POST_INC, offset), myLVal(lvalIn){ }
+	LValNode * getLVal() const { return myLVal; }
 private:
 	LValNode * myLVal;
 };
 
 class IfStmtNode : public StmtNode{
 public:
-	IfStmtNode(size_t l, size_t c, ExpNode * condIn,
-	  std::list<StmtNode *> * bodyIn)
-	: StmtNode(l, c), myCond(condIn), myBody(bodyIn){ }
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *, TypeNode *) override;
+	IfStmtNode(size_t offset, ExpNode * condIn,
+	  Span<StmtNode *> bodyIn)
+	: StmtNode(NodeKind::IF, offset), myCond(condIn), myBody(bodyIn){ }
+	ExpNode * getCond() const { return myCond; }
+	Span<StmtNode *> getBody() const { return myBody; }
 private:
 	ExpNode * myCond;
-	std::list<StmtNode *> * myBody;
+	Span<StmtNode *> myBody;
 };
 
 class IfElseStmtNode : public StmtNode{
 public:
-	IfElseStmtNode(size_t l, size_t c, ExpNode * condIn, 
-	  std::list<StmtNode *> * bodyTrueIn,
-	  std::list<StmtNode *> * bodyFalseIn)
-	: StmtNode(l, c), myCond(condIn),
+	IfElseStmtNode(size_t offset, ExpNode * condIn, 
+	  Span<StmtNode *> bodyTrueIn,
+	  Span<StmtNode *> bodyFalseIn)
+	: StmtNode(NodeKind::IF_ELSE, offset), myCond(condIn),
 	  myBodyTrue(bodyTrueIn), myBodyFalse(bodyFalseIn) { }
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *, TypeNode *) override;
+	ExpNode * getCond() const { return myCond; }
+	Span<StmtNode *> getBodyTrue() const { return myBodyTrue; }
+	Span<StmtNode *> getBodyFalse() const { return myBodyFalse; }
 private:
 	ExpNode * myCond;
-	std::list<StmtNode *> * myBodyTrue;
-	std::list<StmtNode *> * myBodyFalse;
+	Span<StmtNode *> myBodyTrue;
+	Span<StmtNode *> myBodyFalse;
 };
 
 class WhileStmtNode : public StmtNode{
 public:
-	WhileStmtNode(size_t l, size_t c, ExpNode * condIn, 
-	  std::list<StmtNode *> * bodyIn)
-	: StmtNode(l, c), myCond(condIn), myBody(bodyIn){ }
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *, TypeNode *) override;
+	WhileStmtNode(size_t offset, ExpNode * condIn, 
+	  Span<StmtNode *> bodyIn)
+	: StmtNode(NodeKind::WHILE, offset), myCond(condIn), myBody(bodyIn){ }
+	ExpNode * getCond() const { return myCond; }
+	Span<StmtNode *> getBody() const { return myBody; }
 private:
 	ExpNode * myCond;
-	std::list<StmtNode *> * myBody;
+	Span<StmtNode *> myBody;
 };
 
 class ReturnStmtNode : public StmtNode{
 public:
-	ReturnStmtNode(size_t l, size_t c, ExpNode * exp)
-	: StmtNode(l, c), myExp(exp){ }
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *, TypeNode *) override;
+	ReturnStmtNode(size_t offset, ExpNode * exp)
+	: StmtNode(NodeKind::RETURN, offset), myExp(exp){ }
+	//nullptr for a bare return
+	ExpNode * getExp() const { return myExp; }
 private:
 	ExpNode * myExp;
 };
 
 class CallExpNode : public ExpNode{
 public:
-	CallExpNode(size_t l, size_t c, IDNode * id,
-	  std::list<ExpNode *> * argsIn)
-	: ExpNode(l, c), myID(id), myArgs(argsIn){ }
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	CallExpNode(size_t offset, IDNode * id,
+	  Span<ExpNode *> argsIn)
+	: ExpNode(NodeKind::CALL_EXP, offset), myID(id), myArgs(argsIn){ }
+	IDNode * ID() const { return myID; }
+	Span<ExpNode *> getArgs() const { return myArgs; }
 private:
 	IDNode * myID;
-	std::list<ExpNode *> * myArgs;
+	Span<ExpNode *> myArgs;
 };
 
 class BinaryExpNode : public ExpNode{
 public:
-	BinaryExpNode(size_t lIn, size_t cIn, ExpNode * lhs, ExpNode * rhs)
-	: ExpNode(lIn, cIn), myExp1(lhs), myExp2(rhs) { }
-	bool nameAnalysis(SymbolTable * symTab) override;
+	BinaryExpNode(NodeKind kind, size_t offset,
+	  ExpNode * lhs, ExpNode * rhs)
+	: ExpNode(kind, offset), myExp1(lhs), myExp2(rhs) { }
+	ExpNode * getExp1() const { return myExp1; }
+	ExpNode * getExp2() const { return myExp2; }
 protected:
 	ExpNode * myExp1;
 	ExpNode * myExp2;
@@ -344,167 +343,126 @@ protected:
 
 class PlusNode : public BinaryExpNode{
 public:
-	PlusNode(size_t l, size_t c, ExpNode * e1, ExpNode * e2)
-	: BinaryExpNode(l, c, e1, e2){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	PlusNode(size_t offset, ExpNode * e1, ExpNode * e2)
+	: BinaryExpNode(NodeKind::PLUS, offset, e1, e2){ }
 };
 
 class MinusNode : public BinaryExpNode{
 public:
-	MinusNode(size_t l, size_t c, ExpNode * e1, ExpNode * e2)
-	: BinaryExpNode(l, c, e1, e2){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	MinusNode(size_t offset, ExpNode * e1, ExpNode * e2)
+	: BinaryExpNode(NodeKind::MINUS, offset, e1, e2){ }
 };
 
 class TimesNode : public BinaryExpNode{
 public:
-	TimesNode(size_t l, size_t c, ExpNode * e1In, ExpNode * e2In)
-	: BinaryExpNode(l, c, e1In, e2In){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	TimesNode(size_t offset, ExpNode * e1In, ExpNode * e2In)
+	: BinaryExpNode(NodeKind::TIMES, offset, e1In, e2In){ }
 };
 
 class DivideNode : public BinaryExpNode{
 public:
-	DivideNode(size_t lIn, size_t cIn, ExpNode * e1, ExpNode * e2)
-	: BinaryExpNode(lIn, cIn, e1, e2){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	DivideNode(size_t offset, ExpNode * e1, ExpNode * e2)
+	: BinaryExpNode(NodeKind::DIVIDE, offset, e1, e2){ }
 };
 
 class AndNode : public BinaryExpNode{
 public:
-	AndNode(size_t l, size_t c, ExpNode * e1, ExpNode * e2)
-	: BinaryExpNode(l, c, e1, e2){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	AndNode(size_t offset, ExpNode * e1, ExpNode * e2)
+	: BinaryExpNode(NodeKind::AND, offset, e1, e2){ }
 };
 
 class OrNode : public BinaryExpNode{
 public:
-	OrNode(size_t l, size_t c, ExpNode * e1, ExpNode * e2)
-	: BinaryExpNode(l, c, e1, e2){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	OrNode(size_t offset, ExpNode * e1, ExpNode * e2)
+	: BinaryExpNode(NodeKind::OR, offset, e1, e2){ }
 };
 
 class EqualsNode : public BinaryExpNode{
 public:
-	EqualsNode(size_t l, size_t c, ExpNode * e1, ExpNode * e2)
-	: BinaryExpNode(l, c, e1, e2){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	EqualsNode(size_t offset, ExpNode * e1, ExpNode * e2)
+	: BinaryExpNode(NodeKind::EQUALS, offset, e1, e2){ }
 };
 
 class NotEqualsNode : public BinaryExpNode{
 public:
-	NotEqualsNode(size_t l, size_t c, ExpNode * e1, ExpNode * e2)
-	: BinaryExpNode(l, c, e1, e2){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	NotEqualsNode(size_t offset, ExpNode * e1, ExpNode * e2)
+	: BinaryExpNode(NodeKind::NOT_EQUALS, offset, e1, e2){ }
 };
 
 class LessNode : public BinaryExpNode{
 public:
-	LessNode(size_t lineIn, size_t colIn, 
+	LessNode(size_t offset, 
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(lineIn, colIn, exp1, exp2){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	: BinaryExpNode(NodeKind::LESS, offset, exp1, exp2){ }
 };
 
 class LessEqNode : public BinaryExpNode{
 public:
-	LessEqNode(size_t l, size_t c, ExpNode * e1, ExpNode * e2)
-	: BinaryExpNode(l, c, e1, e2){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	LessEqNode(size_t offset, ExpNode * e1, ExpNode * e2)
+	: BinaryExpNode(NodeKind::LESS_EQ, offset, e1, e2){ }
 };
 
 class GreaterNode : public BinaryExpNode{
 public:
-	GreaterNode(size_t lineIn, size_t colIn, 
+	GreaterNode(size_t offset, 
 		ExpNode * exp1, ExpNode * exp2)
-	: BinaryExpNode(lineIn, colIn, exp1, exp2){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	: BinaryExpNode(NodeKind::GREATER, offset, exp1, exp2){ }
 };
 
 class GreaterEqNode : public BinaryExpNode{
 public:
-	GreaterEqNode(size_t l, size_t c, ExpNode * e1, ExpNode * e2)
-	: BinaryExpNode(l, c, e1, e2){ }
-	void unparse(std::ostream& out, int indent) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	GreaterEqNode(size_t offset, ExpNode * e1, ExpNode * e2)
+	: BinaryExpNode(NodeKind::GREATER_EQ, offset, e1, e2){ }
 };
 
 class UnaryExpNode : public ExpNode {
 public:
-	UnaryExpNode(size_t lIn, size_t cIn, ExpNode * expIn) 
-	: ExpNode(lIn, cIn){
+	UnaryExpNode(NodeKind kind, size_t offset, ExpNode * expIn) 
+	: ExpNode(kind, offset){
 		this->myExp = expIn;
 	}
-	virtual void unparse(std::ostream& out, int indent) override = 0;
-	virtual bool nameAnalysis(SymbolTable * symTab) override = 0;
+	ExpNode * getExp() const { return myExp; }
 protected:
 	ExpNode * myExp;
 };
 
 class NegNode : public UnaryExpNode{
 public:
-	NegNode(size_t l, size_t c, ExpNode * exp)
-	: UnaryExpNode(l, c, exp){ }
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	NegNode(size_t offset, ExpNode * exp)
+	: UnaryExpNode(NodeKind::NEG, offset, exp){ }
 };
 
 class NotNode : public UnaryExpNode{
 public:
-	NotNode(size_t lIn, size_t cIn, ExpNode * exp)
-	: UnaryExpNode(lIn, cIn, exp){ }
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	NotNode(size_t offset, ExpNode * exp)
+	: UnaryExpNode(NodeKind::NOT, offset, exp){ }
 };
 
 class VoidTypeNode : public TypeNode{
 public:
-	VoidTypeNode(size_t l, size_t c) : TypeNode(l, c){}
-	void unparse(std::ostream& out, int indent) override;
-	virtual DataType * getType() override { 
-		return BasicType::VOID(); 
-	}
+	VoidTypeNode(size_t offset)
+	: TypeNode(NodeKind::VOID_TYPE, offset, false){}
 };
 
 class IntTypeNode : public TypeNode{
 public:
-	IntTypeNode(size_t l, size_t c, bool ptrIn): TypeNode(l, c), isPtr(ptrIn){}
-	void unparse(std::ostream& out, int indent) override;
-	virtual DataType * getType() override;
-private:
-	const bool isPtr;
+	IntTypeNode(size_t offset, bool ptrIn)
+	: TypeNode(NodeKind::INT_TYPE, offset, ptrIn){}
 };
 
 class BoolTypeNode : public TypeNode{
 public:
-	BoolTypeNode(size_t l, size_t c, bool ptrIn): TypeNode(l, c), isPtr(ptrIn) { }
-	void unparse(std::ostream& out, int indent) override;
-	virtual DataType * getType() override;
-private:
-	const bool isPtr;
+	BoolTypeNode(size_t offset, bool ptrIn)
+	: TypeNode(NodeKind::BOOL_TYPE, offset, ptrIn) { }
 };
 
 
 class AssignExpNode : public ExpNode{
 public:
-	AssignExpNode(size_t l, size_t c, LValNode * dstIn, ExpNode * srcIn)
-	: ExpNode(l, c), myDst(dstIn), mySrc(srcIn){ }
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	AssignExpNode(size_t offset, LValNode * dstIn, ExpNode * srcIn)
+	: ExpNode(NodeKind::ASSIGN_EXP, offset), myDst(dstIn), mySrc(srcIn){ }
+	LValNode * getDst() const { return myDst; }
+	ExpNode * getSrc() const { return mySrc; }
 private:
 	LValNode * myDst;
 	ExpNode * mySrc;
@@ -512,89 +470,76 @@ private:
 
 class IntLitNode : public ExpNode{
 public:
-	IntLitNode(size_t l, size_t c, const int numIn)
-	: ExpNode(l, c), myNum(numIn){ }
-	virtual void unparseNested(std::ostream& out) override{
-		unparse(out, 0);
-	}
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	IntLitNode(size_t offset, const int numIn)
+	: ExpNode(NodeKind::INT_LIT, offset), myNum(numIn){ }
+	int getNum() const { return myNum; }
 private:
 	const int myNum;
 };
 
 class StrLitNode : public ExpNode{
 public:
-	StrLitNode(size_t l, size_t c, const std::string strIn)
-	: ExpNode(l, c), myStr(strIn){ }
-	virtual void unparseNested(std::ostream& out) override{
-		unparse(out, 0);
-	}
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable *) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	//text is a view into the source, like the token's
+	StrLitNode(size_t offset, const char * textIn, size_t lenIn)
+	: ExpNode(NodeKind::STR_LIT, offset), myStr(textIn), myLen(lenIn){ }
+	const char * getStr() const { return myStr; }
+	size_t getLen() const { return myLen; }
 private:
-	 const std::string myStr;
+	 const char * myStr;
+	 size_t myLen;
 };
 
 class CharLitNode : public ExpNode{
 public:
-	CharLitNode(size_t l, size_t c, const char valIn)
-	: ExpNode(l, c), myVal(valIn){ }
-	virtual void unparseNested(std::ostream& out) override{
-		unparse(out, 0);
-	}
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable *) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	CharLitNode(size_t offset, const char valIn)
+	: ExpNode(NodeKind::CHAR_LIT, offset), myVal(valIn){ }
+	char getVal() const { return myVal; }
 private:
 	 const char myVal;
 };
 
 class NullPtrNode : public ExpNode{
 public:
-	NullPtrNode(size_t l, size_t c): ExpNode(l, c){ }
-	virtual void unparseNested(std::ostream& out) override{
-		unparse(out, 0);
-	}
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable *) override;
+	NullPtrNode(size_t offset): ExpNode(NodeKind::NULLPTR_LIT, offset){ }
 };
 
 class TrueNode : public ExpNode{
 public:
-	TrueNode(size_t l, size_t c): ExpNode(l, c){ }
-	virtual void unparseNested(std::ostream& out) override{
-		unparse(out, 0);
-	}
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	TrueNode(size_t offset): ExpNode(NodeKind::TRUE_LIT, offset){ }
 };
 
 class FalseNode : public ExpNode{
 public:
-	FalseNode(size_t l, size_t c): ExpNode(l, c){ }
-	virtual void unparseNested(std::ostream& out) override{
-		unparse(out, 0);
-	}
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *) override;
+	FalseNode(size_t offset): ExpNode(NodeKind::FALSE_LIT, offset){ }
 };
 
 class CallStmtNode : public StmtNode{
 public:
-	CallStmtNode(size_t l, size_t c, CallExpNode * expIn)
-	: StmtNode(l, c), myCallExp(expIn){ }
-	void unparse(std::ostream& out, int indent) override;
-	bool nameAnalysis(SymbolTable * symTab) override;
-	virtual void typeAnalysis(TypeAnalysis *, TypeNode *) override;
+	CallStmtNode(size_t offset, CallExpNode * expIn)
+	: StmtNode(NodeKind::CALL_STMT, offset), myCallExp(expIn){ }
+	CallExpNode * getCallExp() const { return myCallExp; }
 private:
 	CallExpNode * myCallExp;
 };
 
+//Unparses a program one global declaration at a time, as the
+// parser finishes each one (see ParseOptions::stream), rather
+// than after the whole AST has been built. Once written, a
+// declaration is freed from the arena, so the memory a parse
+// needs is bounded by its largest global, not the whole file.
+class StreamingUnparser{
+public:
+	//Nodes are freed back to where arena was when the
+	// unparser was made
+	StreamingUnparser(OutBuffer& outIn, Arena * arenaIn)
+	: myOut(outIn), myArena(arenaIn), myMark(arenaIn->mark()){ }
+	void emit(DeclNode * decl);
+private:
+	OutBuffer& myOut;
+	Arena * myArena;
+	Arena::Mark myMark;
+};
+
 } //End namespace holeyc
 
 #endif
@@ -0,0 +1,243 @@
+#ifndef HOLEYC_AST_VISITOR_HPP
+#define HOLEYC_AST_VISITOR_HPP
+
+#include "ast.hpp"
+#include "errors.hpp"
+
+namespace holeyc{
+
+//A pass over the AST. visit() switches on the node's kind and
+// calls the Derived method for its class, e.g. visitPlus for a
+// PlusNode. The calls are static, so they can be inlined, and a
+// pass touches nothing in ast.hpp. Derived declares (publicly)
+// only the methods it cares about; the rest fall back to the
+// method for the node's base class, in the same order as the
+// class hierarchy:
+//  visitFormalDecl -> visitVarDecl -> visitDecl -> visitStmt
+//  visitPlus -> visitBinaryExp -> visitExp, visitID -> visitLVal
+//  -> visitExp, and so on, ending at visitNode, which throws.
+//State a pass needs on the way down (an indent level, the
+// enclosing function) lives in Derived, not in arguments.
+template <typename Derived, typename Result = void>
+class ASTVisitor{
+public:
+	Result visit(ASTNode * node){
+		NodeKind kind = node->kind();
+		if (kind == NodeKind::PROGRAM){
+			return self()->visitProgram(static_cast<ProgramNode *>(node));
+		} else if (kind <= NodeKind::CALL_STMT){
+			return visit(static_cast<StmtNode *>(node));
+		} else if (kind <= NodeKind::FALSE_LIT){
+			return visit(static_cast<ExpNode *>(node));
+		} else {
+			return visit(static_cast<TypeNode *>(node));
+		}
+	}
+	Result visit(StmtNode * node){
+		switch (node->kind()){
+		case NodeKind::VAR_DECL:
+			return self()->visitVarDecl(static_cast<VarDeclNode *>(node));
+		case NodeKind::FORMAL_DECL:
+			return self()->visitFormalDecl(
+				static_cast<FormalDeclNode *>(node));
+		case NodeKind::FN_DECL:
+			return outOfLine(static_cast<FnDeclNode *>(node));
+		case NodeKind::ASSIGN_STMT:
+			return self()->visitAssignStmt(
+				static_cast<AssignStmtNode *>(node));
+		case NodeKind::FROM_CONSOLE:
+			return self()->visitFromConsole(
+				static_cast<FromConsoleStmtNode *>(node));
+		case NodeKind::TO_CONSOLE:
+			return self()->visitToConsole(
+				static_cast<ToConsoleStmtNode *>(node));
+		case NodeKind::POST_DEC:
+			return self()->visitPostDec(static_cast<PostDecStmtNode *>(node));
+		case NodeKind::POST_INC:
+			return self()->visitPostInc(static_cast<PostIncStmtNode *>(node));
+		case NodeKind::IF:
+			return outOfLine(static_cast<IfStmtNode *>(node));
+		case NodeKind::IF_ELSE:
+			return outOfLine(static_cast<IfElseStmtNode *>(node));
+		case NodeKind::WHILE:
+			return outOfLine(static_cast<WhileStmtNode *>(node));
+		case NodeKind::RETURN:
+			return self()->visitReturn(static_cast<ReturnStmtNode *>(node));
+		case NodeKind::CALL_STMT:
+			return self()->visitCallStmt(static_cast<CallStmtNode *>(node));
+		default:
+			throw new InternalError("Not a statement");
+		}
+	}
+	Result visit(ExpNode * node){
+		switch (node->kind()){
+		case NodeKind::ID:
+			return self()->visitID(static_cast<IDNode *>(node));
+		case NodeKind::REF:
+			return self()->visitRef(static_cast<RefNode *>(node));
+		case NodeKind::DEREF:
+			return self()->visitDeref(static_cast<DerefNode *>(node));
+		case NodeKind::INDEX:
+			return self()->visitIndex(static_cast<IndexNode *>(node));
+		case NodeKind::CALL_EXP:
+			return self()->visitCallExp(static_cast<CallExpNode *>(node));
+		case NodeKind::ASSIGN_EXP:
+			return self()->visitAssignExp(static_cast<AssignExpNode *>(node));
+		case NodeKind::PLUS:
+			return self()->visitPlus(static_cast<PlusNode *>(node));
+		case NodeKind::MINUS:
+			return self()->visitMinus(static_cast<MinusNode *>(node));
+		case NodeKind::TIMES:
+			return self()->visitTimes(static_cast<TimesNode *>(node));
+		case NodeKind::DIVIDE:
+			return self()->visitDivide(static_cast<DivideNode *>(node));
+		case NodeKind::AND:
+			return self()->visitAnd(static_cast<AndNode *>(node));
+		case NodeKind::OR:
+			return self()->visitOr(static_cast<OrNode *>(node));
+		case NodeKind::EQUALS:
+			return self()->visitEquals(static_cast<EqualsNode *>(node));
+		case NodeKind::NOT_EQUALS:
+			return self()->visitNotEquals(static_cast<NotEqualsNode *>(node));
+		case NodeKind::LESS:
+			return self()->visitLess(static_cast<LessNode *>(node));
+		case NodeKind::LESS_EQ:
+			return self()->visitLessEq(static_cast<LessEqNode *>(node));
+		case NodeKind::GREATER:
+			return self()->visitGreater(static_cast<GreaterNode *>(node));
+		case NodeKind::GREATER_EQ:
+			return self()->visitGreaterEq(static_cast<GreaterEqNode *>(node));
+		case NodeKind::NEG:
+			return self()->visitNeg(static_cast<NegNode *>(node));
+		case NodeKind::NOT:
+			return self()->visitNot(static_cast<NotNode *>(node));
+		case NodeKind::INT_LIT:
+			return self()->visitIntLit(static_cast<IntLitNode *>(node));
+		case NodeKind::STR_LIT:
+			return self()->visitStrLit(static_cast<StrLitNode *>(node));
+		case NodeKind::CHAR_LIT:
+			return self()->visitCharLit(static_cast<CharLitNode *>(node));
+		case NodeKind::NULLPTR_LIT:
+			return self()->visitNullPtr(static_cast<NullPtrNode *>(node));
+		case NodeKind::TRUE_LIT:
+			return self()->visitTrue(static_cast<TrueNode *>(node));
+		case NodeKind::FALSE_LIT:
+			return self()->visitFalse(static_cast<FalseNode *>(node));
+		default:
+			throw new InternalError("Not an expression");
+		}
+	}
+	Result visit(TypeNode * node){
+		switch (node->kind()){
+		case NodeKind::VOID_TYPE:
+			return self()->visitVoidType(static_cast<VoidTypeNode *>(node));
+		case NodeKind::INT_TYPE:
+			return self()->visitIntType(static_cast<IntTypeNode *>(node));
+		case NodeKind::BOOL_TYPE:
+			return self()->visitBoolType(static_cast<BoolTypeNode *>(node));
+		case NodeKind::CHAR_TYPE:
+			return self()->visitCharType(static_cast<CharTypeNode *>(node));
+		default:
+			throw new InternalError("Not a type");
+		}
+	}
+	//The class of an ID is known, so it needs no switch
+	Result visit(IDNode * node){ return self()->visitID(node); }
+
+	Result visitNode(ASTNode *){
+		throw new InternalError("Node kind not handled by pass");
+	}
+	Result visitProgram(ProgramNode * node){ return self()->visitNode(node); }
+
+	Result visitStmt(StmtNode * node){ return self()->visitNode(node); }
+	Result visitDecl(DeclNode * node){ return self()->visitStmt(node); }
+	Result visitVarDecl(VarDeclNode * node){ return self()->visitDecl(node); }
+	Result visitFormalDecl(FormalDeclNode * node){
+		return self()->visitVarDecl(node);
+	}
+	Result visitFnDecl(FnDeclNode * node){ return self()->visitDecl(node); }
+	Result visitAssignStmt(AssignStmtNode * node){
+		return self()->visitStmt(node);
+	}
+	Result visitFromConsole(FromConsoleStmtNode * node){
+		return self()->visitStmt(node);
+	}
+	Result visitToConsole(ToConsoleStmtNode * node){
+		return self()->visitStmt(node);
+	}
+	Result visitPostDec(PostDecStmtNode * node){ return self()->visitStmt(node); }
+	Result visitPostInc(PostIncStmtNode * node){ return self()->visitStmt(node); }
+	Result visitIf(IfStmtNode * node){ return self()->visitStmt(node); }
+	Result visitIfElse(IfElseStmtNode * node){ return self()->visitStmt(node); }
+	Result visitWhile(WhileStmtNode * node){ return self()->visitStmt(node); }
+	Result visitReturn(ReturnStmtNode * node){ return self()->visitStmt(node); }
+	Result visitCallStmt(CallStmtNode * node){ return self()->visitStmt(node); }
+
+	Result visitExp(ExpNode * node){ return self()->visitNode(node); }
+	Result visitLVal(LValNode * node){ return self()->visitExp(node); }
+	Result visitID(IDNode * node){ return self()->visitLVal(node); }
+	Result visitRef(RefNode * node){ return self()->visitLVal(node); }
+	Result visitDeref(DerefNode * node){ return self()->visitLVal(node); }
+	Result visitIndex(IndexNode * node){ return self()->visitLVal(node); }
+	Result visitCallExp(CallExpNode * node){ return self()->visitExp(node); }
+	Result visitAssignExp(AssignExpNode * node){ return self()->visitExp(node); }
+	Result visitBinaryExp(BinaryExpNode * node){ return self()->visitExp(node); }
+	Result visitPlus(PlusNode * node){ return self()->visitBinaryExp(node); }
+	Result visitMinus(MinusNode * node){ return self()->visitBinaryExp(node); }
+	Result visitTimes(TimesNode * node){ return self()->visitBinaryExp(node); }
+	Result visitDivide(DivideNode * node){ return self()->visitBinaryExp(node); }
+	Result visitAnd(AndNode * node){ return self()->visitBinaryExp(node); }
+	Result visitOr(OrNode * node){ return self()->visitBinaryExp(node); }
+	Result visitEquals(EqualsNode * node){ return self()->visitBinaryExp(node); }
+	Result visitNotEquals(NotEqualsNode * node){
+		return self()->visitBinaryExp(node);
+	}
+	Result visitLess(LessNode * node){ return self()->visitBinaryExp(node); }
+	Result visitLessEq(LessEqNode * node){ return self()->visitBinaryExp(node); }
+	Result visitGreater(GreaterNode * node){
+		return self()->visitBinaryExp(node);
+	}
+	Result visitGreaterEq(GreaterEqNode * node){
+		return self()->visitBinaryExp(node);
+	}
+	Result visitUnaryExp(UnaryExpNode * node){ return self()->visitExp(node); }
+	Result visitNeg(NegNode * node){ return self()->visitUnaryExp(node); }
+	Result visitNot(NotNode * node){ return self()->visitUnaryExp(node); }
+	Result visitIntLit(IntLitNode * node){ return self()->visitExp(node); }
+	Result visitStrLit(StrLitNode * node){ return self()->visitExp(node); }
+	Result visitCharLit(CharLitNode * node){ return self()->visitExp(node); }
+	Result visitNullPtr(NullPtrNode * node){ return self()->visitExp(node); }
+	Result visitTrue(TrueNode * node){ return self()->visitExp(node); }
+	Result visitFalse(FalseNode * node){ return self()->visitExp(node); }
+
+	Result visitType(TypeNode * node){ return self()->visitNode(node); }
+	Result visitVoidType(VoidTypeNode * node){ return self()->visitType(node); }
+	Result visitIntType(IntTypeNode * node){ return self()->visitType(node); }
+	Result visitBoolType(BoolTypeNode * node){ return self()->visitType(node); }
+	Result visitCharType(CharTypeNode * node){ return self()->visitType(node); }
+private:
+	//Statements with bodies are called through these rather than
+	// inlined into visit(StmtNode *). They recurse back into it,
+	// and inlining them would make every statement pay for the
+	// registers and stack the biggest of them needs.
+	__attribute__((noinline)) Result outOfLine(FnDeclNode * node){
+		return self()->visitFnDecl(node);
+	}
+	__attribute__((noinline)) Result outOfLine(IfStmtNode * node){
+		return self()->visitIf(node);
+	}
+	__attribute__((noinline)) Result outOfLine(IfElseStmtNode * node){
+		return self()->visitIfElse(node);
+	}
+	__attribute__((noinline)) Result outOfLine(WhileStmtNode * node){
+		return self()->visitWhile(node);
+	}
+
+	//The fallbacks go through Derived too, so that overriding
+	// visitBinaryExp, say, covers every binary operator
+	Derived * self(){ return static_cast<Derived *>(this); }
+};
+
+}
+
+#endif
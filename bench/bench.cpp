@@ -0,0 +1,605 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "arena.hpp"
+#include "source_buffer.hpp"
+#include "scanner.hpp"
+#include "simd_lexer.hpp"
+#include "chunked_lexer.hpp"
+#include "pipelined_lexer.hpp"
+#include "name_analysis.hpp"
+#include "type_analysis.hpp"
+#include "source_manager.hpp"
+
+using namespace holeyc;
+
+//Benchmarks for the front end. Run with `make bench`; pass
+// the size of the generated input in megabytes as the only
+// argument (default 16). Build with OPT=-O2 for numbers
+// worth comparing.
+
+using Clock = std::chrono::steady_clock;
+
+//Every heap allocation in the process goes through here, so
+// the benchmarks can report how many each phase makes
+static std::atomic<size_t> allocCount(0);
+
+void * operator new(size_t size){
+	allocCount.fetch_add(1, std::memory_order_relaxed);
+	void * res = malloc(size == 0 ? 1 : size);
+	if (res == nullptr){ throw std::bad_alloc(); }
+	return res;
+}
+
+void operator delete(void * ptr) noexcept{
+	free(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept{
+	free(ptr);
+}
+
+static double secondsSince(Clock::time_point start){
+	std::chrono::duration<double> d = Clock::now() - start;
+	return d.count();
+}
+
+//A large, valid HoleyC program made of many copies of a
+// function that exercises most of the token kinds, with
+// comments and indentation typical of generated code.
+static std::string makeProgram(size_t bytes){
+	std::string prog;
+	prog.reserve(bytes + 1024);
+	prog += "# generated benchmark input\n";
+	prog += "int counter;\ncharptr banner;\n";
+	for (size_t i = 0; prog.size() < bytes; i++){
+		std::string n = std::to_string(i);
+		prog += "int fn" + n + "(int a, int b, boolptr flags){\n"
+		  "\t# locals\n"
+		  "\tint total;\n"
+		  "\tbool done;\n"
+		  "\tchar c;\n"
+		  "\ttotal = a * 10 + b / 3 - " + n + ";\n"
+		  "\tdone = false;\n"
+		  "\tc = 'x;\n"
+		  "\twhile (total > 0 && !done){\n"
+		  "\t\ttotal--;\n"
+		  "\t\tif (total == 17 || total <= 3){\n"
+		  "\t\t\tTOCONSOLE \"reached a checkpoint\\n\";\n"
+		  "\t\t\tdone = true;\n"
+		  "\t\t} else {\n"
+		  "\t\t\tcounter++;\n"
+		  "\t\t}\n"
+		  "\t}\n"
+		  "\treturn total;\n"
+		  "}\n";
+	}
+	return prog;
+}
+
+static SourceBuffer * writeInput(const std::string& prog){
+	char path[] = "/tmp/holeycbenchXXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0){ return nullptr; }
+	close(fd);
+	std::ofstream out(path);
+	out << prog;
+	out.close();
+	SourceBuffer * src = SourceBuffer::open(path);
+	unlink(path);
+	return src;
+}
+
+static void report(const char * what, size_t bytes, size_t tokens,
+  double secs){
+	double mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+	if (tokens == 0){
+		printf("  %-28s %9.1f MB/s  %19s  %8.3f s\n",
+			what, mb / secs, "", secs);
+		return;
+	}
+	printf("  %-28s %9.1f MB/s  %12zu tokens  %8.3f s\n",
+		what, mb / secs, tokens, secs);
+}
+
+//Lex the whole input through a Scanner, as the parser would
+static size_t lexAll(Scanner * scanner){
+	Parser::semantic_type lval;
+	size_t count = 0;
+	int kind;
+	while ((kind = scanner->yylex(&lval)) != Parser::token::END){
+		Scanner::dropLexeme(kind, &lval);
+		count++;
+	}
+	return count;
+}
+
+static void benchLexers(SourceBuffer * src){
+	printf("lexing:\n");
+	size_t bytes = src->size();
+	for (int rep = 0; rep < 2; rep++){
+		Clock::time_point start = Clock::now();
+		Scanner * flex = new Scanner(src);
+		size_t count = lexAll(flex);
+		delete flex;
+		report("flex Scanner", bytes, count, secondsSince(start));
+
+		start = Clock::now();
+		Scanner * simd = new Scanner(new SimdLexer(src));
+		count = lexAll(simd);
+		delete simd;
+		report("SimdLexer via Scanner", bytes, count,
+			secondsSince(start));
+
+		start = Clock::now();
+		SimdLexer raw(src);
+		RawToken tok;
+		count = 0;
+		do {
+			raw.next(tok);
+			count++;
+		} while (tok.kind != Parser::token::END);
+		report("SimdLexer raw tokens", bytes, count - 1,
+			secondsSince(start));
+
+		size_t threads = std::thread::hardware_concurrency();
+		if (threads < 2){ threads = 2; }
+		ThreadPool pool(threads);
+		start = Clock::now();
+		ChunkedLexer chunked(src, &pool, threads * 4);
+		count = 0;
+		do {
+			chunked.next(tok);
+			count++;
+		} while (tok.kind != Parser::token::END);
+		std::string what = "ChunkedLexer, " 
+			+ std::to_string(threads) + " threads";
+		report(what.c_str(), bytes, count - 1, secondsSince(start));
+	}
+}
+
+//Parse, building the AST unless opts says only to recognize.
+// If arenaBytes is given, it gets how much of the arena the
+// parse used.
+static double timeParse(Scanner * scanner, 
+  ParseOptions opts = ParseOptions(), size_t * arenaBytes = nullptr){
+	Arena arena;
+	ArenaScope scope(&arena);
+	Clock::time_point start = Clock::now();
+	ProgramNode * root = nullptr;
+	Parser parser(*scanner, &root, opts);
+	if (parser.parse() != 0 || (opts.buildAST && root == nullptr)){
+		std::cerr << "benchmark input failed to parse\n";
+		exit(1);
+	}
+	double secs = secondsSince(start);
+	delete scanner;
+	if (arenaBytes != nullptr){ *arenaBytes = arena.bytesUsed(); }
+	return secs;
+}
+
+static ParseOptions recognizeOnly(){
+	ParseOptions opts;
+	opts.buildAST = false;
+	return opts;
+}
+
+static size_t countLines(SourceBuffer * src){
+	size_t lines = 0;
+	for (const char * c = src->data(); c != src->end(); c++){
+		if (*c == '\n'){ lines++; }
+	}
+	return lines;
+}
+
+//Lex+parse to an AST, with the lexer inline on the parser's
+// thread and with it pipelined on a thread of its own
+static void benchParse(SourceBuffer * src){
+	printf("parsing:\n");
+	size_t bytes = src->size();
+	for (int rep = 0; rep < 2; rep++){
+		double flexSecs = timeParse(new Scanner(src));
+		report("flex, inline", bytes, 0, flexSecs);
+		double simdSecs = timeParse(new Scanner(new SimdLexer(src)));
+		report("simd, inline", bytes, 0, simdSecs);
+		double pipeSecs = timeParse(new Scanner(
+			new PipelinedLexer(new SimdLexer(src))));
+		report("simd, pipelined", bytes, 0, pipeSecs);
+		printf("  pipelined speedup over inline simd: %.2fx\n",
+			simdSecs / pipeSecs);
+	}
+
+	//The syntax check (-p) only needs accept/reject
+	double lines = static_cast<double>(countLines(src));
+	for (int rep = 0; rep < 2; rep++){
+		double buildSecs = timeParse(new Scanner(new SimdLexer(src)));
+		printf("  %-28s %9.0f lines/s\n", "simd, building AST",
+			lines / buildSecs);
+		double recSecs = timeParse(new Scanner(new SimdLexer(src)),
+			recognizeOnly());
+		printf("  %-28s %9.0f lines/s\n", "simd, recognizer only",
+			lines / recSecs);
+	}
+}
+
+static bool hasPayload(int kind){
+	return kind == Parser::token::ID
+		|| kind == Parser::token::INTLITERAL
+		|| kind == Parser::token::STRLITERAL
+		|| kind == Parser::token::CHARLIT;
+}
+
+//Count the heap allocations made handing each token from the
+// scanner to the parser, split between bare tokens (keywords
+// and punctuation) and tokens that carry a value
+static void countHandoff(const char * what, Scanner * scanner){
+	Parser::semantic_type lval;
+	size_t bare = 0, bareAllocs = 0;
+	size_t valued = 0, valuedAllocs = 0;
+	while (true){
+		size_t before = allocCount.load();
+		int kind = scanner->yylex(&lval);
+		size_t made = allocCount.load() - before;
+		if (kind == Parser::token::END){ break; }
+		if (hasPayload(kind)){
+			valued++;
+			valuedAllocs += made;
+		} else {
+			bare++;
+			bareAllocs += made;
+		}
+		Scanner::dropLexeme(kind, &lval);
+	}
+	delete scanner;
+	printf("  %-28s bare: %9zu tokens %9zu allocs;"
+		" valued: %9zu tokens %9zu allocs\n",
+		what, bare, bareAllocs, valued, valuedAllocs);
+}
+
+static void benchAllocations(SourceBuffer * src){
+	printf("scanner to parser allocations:\n");
+	countHandoff("flex Scanner", new Scanner(src));
+	countHandoff("SimdLexer via Scanner", new Scanner(new SimdLexer(src)));
+
+	size_t arenaBytes = 0;
+	size_t before = allocCount.load();
+	timeParse(new Scanner(new SimdLexer(src)), ParseOptions(),
+		&arenaBytes);
+	printf("  %-28s %9zu allocs %12zu arena bytes\n",
+		"full simd parse", allocCount.load() - before, arenaBytes);
+
+	before = allocCount.load();
+	timeParse(new Scanner(new SimdLexer(src)), recognizeOnly(),
+		&arenaBytes);
+	printf("  %-28s %9zu allocs %12zu arena bytes\n",
+		"simd recognizer", allocCount.load() - before, arenaBytes);
+}
+
+//Build the AST in an arena, walk it with name analysis, and
+// free it all at once
+static void benchArena(SourceBuffer * src){
+	printf("arena:\n");
+	for (int rep = 0; rep < 2; rep++){
+		Arena * arena = new Arena();
+		ArenaScope scope(arena);
+		ProgramNode * root = nullptr;
+		Scanner scanner(new SimdLexer(src));
+		Parser parser(scanner, &root, ParseOptions());
+		if (parser.parse() != 0 || root == nullptr){
+			std::cerr << "benchmark input failed to parse\n";
+			exit(1);
+		}
+
+		Clock::time_point start = Clock::now();
+		if (NameAnalysis::build(root) == nullptr){
+			std::cerr << "benchmark input failed name analysis\n";
+			exit(1);
+		}
+		report("name analysis", src->size(), 0, secondsSince(start));
+
+		size_t used = arena->bytesUsed();
+		start = Clock::now();
+		delete arena;
+		double secs = secondsSince(start);
+		printf("  released %zu arena bytes in %.6f s\n", used, secs);
+	}
+}
+
+//Time whole-tree walks over an already built AST
+static void benchTraversal(SourceBuffer * src){
+	printf("traversal:\n");
+	Arena arena;
+	ArenaScope scope(&arena);
+	ProgramNode * root = nullptr;
+	Scanner scanner(new SimdLexer(src));
+	Parser parser(scanner, &root, ParseOptions());
+	if (parser.parse() != 0 || root == nullptr){
+		std::cerr << "benchmark input failed to parse\n";
+		exit(1);
+	}
+	OutBuffer * nullOut = OutBuffer::open("/dev/null");
+	if (nullOut == nullptr){
+		std::cerr << "could not open /dev/null\n";
+		exit(1);
+	}
+	for (int rep = 0; rep < 3; rep++){
+		Clock::time_point start = Clock::now();
+		Scanner tokScanner(new SimdLexer(src));
+		tokScanner.outputTokens(*nullOut);
+		nullOut->flush();
+		report("token output", src->size(), 0, secondsSince(start));
+
+		start = Clock::now();
+		root->unparse(*nullOut, 0);
+		nullOut->flush();
+		report("unparse", src->size(), 0, secondsSince(start));
+
+		start = Clock::now();
+		if (NameAnalysis::build(root) == nullptr){
+			std::cerr << "benchmark input failed name analysis\n";
+			exit(1);
+		}
+		report("name analysis", src->size(), 0, secondsSince(start));
+	}
+	delete nullOut;
+}
+
+//Functions whose bodies nest `depth` ifs deep, each level
+// declaring a local and using names from the levels and
+// globals far above it
+static std::string makeNested(size_t depth, size_t fns){
+	std::string prog;
+	for (size_t g = 0; g < 10; g++){
+		prog += "int g" + std::to_string(g) + ";\n";
+	}
+	for (size_t f = 0; f < fns; f++){
+		prog += "void f" + std::to_string(f) + "(int p){\n";
+		for (size_t d = 1; d <= depth; d++){
+			std::string v = "v" + std::to_string(d);
+			std::string g = "g" + std::to_string(d % 10);
+			prog += "if (true){ int " + v + "; "
+			  + v + " = p + " + g + " + v" 
+			  + std::to_string((d + 1) / 2) + ";\n";
+		}
+		for (size_t d = 0; d < depth; d++){ prog += "}"; }
+		prog += "\n}\n";
+	}
+	return prog;
+}
+
+static double timeNames(ProgramNode * ast, SymbolTable * symTab){
+	Clock::time_point start = Clock::now();
+	if (NameAnalysis::build(ast, symTab) == nullptr){
+		std::cerr << "benchmark input failed name analysis\n";
+		exit(1);
+	}
+	return secondsSince(start);
+}
+
+static void benchSymbolTables(){
+	printf("name analysis, 200-deep nesting:\n");
+	SourceBuffer * src = writeInput(makeNested(200, 200));
+	Arena arena;
+	ArenaScope scope(&arena);
+	ProgramNode * root = nullptr;
+	Scanner scanner(new SimdLexer(src));
+	Parser parser(scanner, &root, ParseOptions());
+	if (parser.parse() != 0 || root == nullptr){
+		std::cerr << "nested input failed to parse\n";
+		exit(1);
+	}
+	for (int rep = 0; rep < 2; rep++){
+		double chain = timeNames(root, new ScopeChainTable());
+		report("scope chain", src->size(), 0, chain);
+		double stack = timeNames(root, new ScopeStackTable());
+		report("scope stack", src->size(), 0, stack);
+		printf("  scope stack speedup: %.2fx\n", chain / stack);
+	}
+	delete src;
+}
+
+//What the arithmetic operators check for their operands:
+// 0 if the result is int, 1 if an error is only passed
+// along, and otherwise 2 plus which operands were bad
+static bool isInt(const DataType * type){ return type->isInt(); }
+static bool isInt(TypeHandle type){ return type.isInt(); }
+
+template <typename T>
+static int checkMath(T exp1, T exp2, bool err1, bool err2){
+	if (exp1 == exp2 && isInt(exp1)){ return 0; }
+	if (err1 && err2){ return 1; }
+	if (err1){ return isInt(exp2) ? 1 : 3; }
+	if (err2){ return isInt(exp1) ? 1 : 2; }
+	return 2 + (isInt(exp1) ? 0 : 1) + (isInt(exp2) ? 0 : 2);
+}
+
+//The operand checks at the heart of type analysis, run over
+// the same operand types as virtual DataType queries and as
+// TypeHandle queries
+static void benchOperandChecks(){
+	const size_t count = 1 << 20;
+	const DataType * pool[] = {
+		BasicType::INT(), BasicType::INT(), BasicType::INT(),
+		BasicType::BOOL(), BasicType::CHAR(), BasicType::VOID(),
+		PtrType::produce(BasicType::INT(), 1),
+		PtrType::produce(BasicType::CHAR(), 1),
+		ErrorType::produce(),
+		FnType::produce(std::vector<const DataType *>(), 
+			BasicType::INT()),
+	};
+	const size_t poolSize = sizeof(pool) / sizeof(pool[0]);
+	std::vector<const DataType *> types(count);
+	std::vector<TypeHandle> handles(count);
+	unsigned seed = 12345;
+	for (size_t i = 0; i < count; i++){
+		seed = seed * 1103515245u + 12345u;
+		types[i] = pool[(seed >> 16) % poolSize];
+		handles[i] = types[i]->handle();
+	}
+
+	for (int rep = 0; rep < 3; rep++){
+		size_t sumVirtual = 0;
+		Clock::time_point start = Clock::now();
+		for (int pass = 0; pass < 20; pass++){
+			for (size_t i = 0; i + 1 < count; i++){
+				const DataType * a = types[i];
+				const DataType * b = types[i + 1];
+				sumVirtual += static_cast<size_t>(checkMath(a, b,
+					a->asError() != nullptr, 
+					b->asError() != nullptr));
+			}
+		}
+		double virtualSecs = secondsSince(start);
+
+		size_t sumHandle = 0;
+		start = Clock::now();
+		for (int pass = 0; pass < 20; pass++){
+			for (size_t i = 0; i + 1 < count; i++){
+				TypeHandle a = handles[i];
+				TypeHandle b = handles[i + 1];
+				sumHandle += static_cast<size_t>(checkMath(a, b,
+					a.isError(), b.isError()));
+			}
+		}
+		double handleSecs = secondsSince(start);
+
+		if (sumVirtual != sumHandle){
+			std::cerr << "operand checks disagree\n";
+			exit(1);
+		}
+		double checks = 20.0 * static_cast<double>(count - 1);
+		printf("  %-28s %9.2f ns/check\n", "virtual DataType",
+			virtualSecs * 1e9 / checks);
+		printf("  %-28s %9.2f ns/check\n", "TypeHandle",
+			handleSecs * 1e9 / checks);
+		printf("  TypeHandle speedup: %.2fx\n", 
+			virtualSecs / handleSecs);
+	}
+}
+
+//Produce the basic and pointer flyweights the way literals,
+// type nodes and ref/deref do, from several threads at once,
+// and check every thread was handed the same instances
+static void benchTypeProduction(){
+	const size_t count = 1 << 22;
+	const size_t numThreads = 4;
+	std::vector<size_t> sums(numThreads);
+	std::vector<std::thread> threads;
+	Clock::time_point start = Clock::now();
+	for (size_t t = 0; t < numThreads; t++){
+		threads.emplace_back([&sums, t, count](){
+			size_t sum = 0;
+			for (size_t i = 0; i < count; i++){
+				BaseType base = static_cast<BaseType>(i % 4);
+				int level = static_cast<int>(i % 3) + 1;
+				const BasicType * basic = BasicType::produce(base);
+				const PtrType * ptr = PtrType::produce(basic, level);
+				sum += reinterpret_cast<uintptr_t>(ptr) 
+				  ^ reinterpret_cast<uintptr_t>(basic);
+			}
+			sums[t] = sum;
+		});
+	}
+	for (std::thread& thread : threads){ thread.join(); }
+	double secs = secondsSince(start);
+	for (size_t t = 1; t < numThreads; t++){
+		if (sums[t] != sums[0]){
+			std::cerr << "threads were given different flyweights\n";
+			exit(1);
+		}
+	}
+	double produced = static_cast<double>(count * numThreads * 2);
+	printf("  %-28s %9.2f ns/type\n", "flyweight production",
+		secs * 1e9 / produced);
+}
+
+//Functions made of expressions that all pass type analysis
+static std::string makeTyped(size_t fns){
+	std::string prog = "int total;\nbool flag;\n";
+	for (size_t f = 0; f < fns; f++){
+		std::string n = std::to_string(f);
+		prog += "int t" + n + "(int a, bool b, charptr s){\n"
+		  "\tint x;\n"
+		  "\tbool y;\n"
+		  "\tx = a * 3 + a / 2 - -total + " + n + ";\n"
+		  "\ty = b && !y || flag == b && y != false;\n"
+		  "\twhile (y || !b){\n"
+		  "\t\tx = x + a * x - total / 7;\n"
+		  "\t\ty = !y && b;\n"
+		  "\t\tx++;\n"
+		  "\t\tx = t0(x, y, s) + x;\n"
+		  "\t}\n"
+		  "\tif (b){ TOCONSOLE s; } else { TOCONSOLE x; }\n"
+		  "\treturn x;\n"
+		  "}\n";
+	}
+	return prog;
+}
+
+static void benchTypes(){
+	printf("type checking:\n");
+	benchOperandChecks();
+	benchTypeProduction();
+
+	SourceBuffer * src = writeInput(makeTyped(40000));
+	Arena arena;
+	ArenaScope scope(&arena);
+	ProgramNode * root = nullptr;
+	Scanner scanner(new SimdLexer(src));
+	Parser parser(scanner, &root, ParseOptions());
+	if (parser.parse() != 0 || root == nullptr){
+		std::cerr << "typed input failed to parse\n";
+		exit(1);
+	}
+	NameAnalysis * names = NameAnalysis::build(root);
+	if (names == nullptr){
+		std::cerr << "typed input failed name analysis\n";
+		exit(1);
+	}
+	for (int rep = 0; rep < 3; rep++){
+		Clock::time_point start = Clock::now();
+		if (TypeAnalysis::build(names) == nullptr){
+			std::cerr << "typed input failed type analysis\n";
+			exit(1);
+		}
+		report("type analysis", src->size(), 0, secondsSince(start));
+	}
+	delete src;
+}
+
+int main(int argc, char * argv[]){
+	size_t megabytes = 16;
+	if (argc > 1){
+		megabytes = static_cast<size_t>(atol(argv[1]));
+	}
+	std::string prog = makeProgram(megabytes * 1024 * 1024);
+	SourceBuffer * src = writeInput(prog);
+	if (src == nullptr){
+		std::cerr << "Could not create benchmark input\n";
+		return 1;
+	}
+	printf("input: %zu bytes\n", src->size());
+	//For the token output's line and column numbers
+	SourceManager sources(src);
+	SourceScope sourceScope(&sources);
+
+	benchLexers(src);
+	benchParse(src);
+	benchAllocations(src);
+	benchArena(src);
+	benchTraversal(src);
+	benchSymbolTables();
+	benchTypes();
+
+	delete src;
+	return 0;
+}
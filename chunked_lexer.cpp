@@ -0,0 +1,82 @@
+#include <string.h>
+
+#include "chunked_lexer.hpp"
+#include "simd_lexer.hpp"
+#include "grammar.hh"
+
+namespace holeyc{
+
+using TokenKind = holeyc::Parser::token;
+
+//Don't bother splitting below this many bytes per chunk
+static const size_t MIN_CHUNK_BYTES = 64 * 1024;
+
+static void lexChunk(const SourceBuffer * src, const char * begin,
+  const char * end, std::vector<RawToken> * out){
+	//A rough guess at token density avoids most regrowth
+	out->reserve(static_cast<size_t>(end - begin) / 4 + 1);
+	SimdLexer lexer(src, begin, end);
+	RawToken tok;
+	do {
+		lexer.next(tok);
+		out->push_back(tok);
+	} while (tok.kind != TokenKind::END);
+}
+
+ChunkedLexer::ChunkedLexer(const SourceBuffer * src, ThreadPool * pool,
+  size_t numChunks)
+: myChunk(0), myIndex(0){
+	const char * begin = src->data();
+	const char * end = src->end();
+	size_t size = src->size();
+	if (numChunks == 0){ numChunks = 1; }
+	if (size / numChunks < MIN_CHUNK_BYTES){
+		numChunks = size / MIN_CHUNK_BYTES + 1;
+	}
+
+	//Cut just after the first newline at or past each even
+	// split point
+	std::vector<const char *> cuts;
+	cuts.push_back(begin);
+	for (size_t k = 1; k < numChunks; k++){
+		const char * target = begin + size / numChunks * k;
+		if (target < cuts.back()){ continue; }
+		const void * nl = memchr(target, '\n',
+			static_cast<size_t>(end - target));
+		if (nl == nullptr){ break; }
+		const char * cut = static_cast<const char *>(nl) + 1;
+		if (cut > cuts.back() && cut < end){ cuts.push_back(cut); }
+	}
+	cuts.push_back(end);
+
+	size_t count = cuts.size() - 1;
+	myChunks.resize(count);
+	for (size_t k = 0; k < count; k++){
+		const char * from = cuts[k];
+		const char * to = cuts[k + 1];
+		std::vector<RawToken> * out = &myChunks[k];
+		pool->submit([src, from, to, out]{
+			lexChunk(src, from, to, out);
+		});
+	}
+	pool->wait();
+}
+
+void ChunkedLexer::next(RawToken& tok){
+	while (true){
+		const std::vector<RawToken>& chunk = myChunks[myChunk];
+		tok = chunk[myIndex];
+		if (tok.kind != TokenKind::END || myChunk + 1 == myChunks.size()){
+			//The final END stays put so repeated calls keep
+			// returning it
+			if (tok.kind != TokenKind::END){ myIndex++; }
+			return;
+		}
+		//The END of an inner chunk just marks where the next
+		// one takes over
+		myChunk++;
+		myIndex = 0;
+	}
+}
+
+}
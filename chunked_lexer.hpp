@@ -0,0 +1,33 @@
+#ifndef HOLEYC_CHUNKED_LEXER_HPP
+#define HOLEYC_CHUNKED_LEXER_HPP
+
+#include <vector>
+
+#include "source_buffer.hpp"
+#include "thread_pool.hpp"
+#include "token_stream.hpp"
+
+namespace holeyc{
+
+//Lexes a source buffer in parallel. HoleyC string literals
+// and comments never span a newline, so the input can be cut
+// just after any newline and each piece lexed on its own.
+// Every chunk is lexed by a SimdLexer on the thread pool;
+// tokens carry offsets into the whole buffer, so next() just
+// replays the chunks in order. The result is the same token
+// stream (and the same lexical errors, in the same order) as
+// lexing the whole buffer in one go.
+class ChunkedLexer : public TokenStream{
+public:
+	ChunkedLexer(const SourceBuffer * src, ThreadPool * pool,
+	  size_t numChunks);
+	void next(RawToken& tok) override;
+private:
+	std::vector<std::vector<RawToken>> myChunks;
+	size_t myChunk;
+	size_t myIndex;
+};
+
+}
+
+#endif
@@ -0,0 +1,161 @@
+#include <memory>
+
+#include "compilation.hpp"
+#include "diagnostics.hpp"
+#include "scanner.hpp"
+#include "simd_lexer.hpp"
+#include "chunked_lexer.hpp"
+#include "pipelined_lexer.hpp"
+#include "token_cache.hpp"
+#include "ast.hpp"
+#include "name_analysis.hpp"
+#include "type_analysis.hpp"
+
+namespace holeyc{
+
+Compilation::~Compilation(){
+	delete myCache;
+}
+
+Scanner * Compilation::makeScanner(){
+	if (mySource->size() >= SourceManager::MAX_SIZE){
+		throw new InternalError("Source file too large");
+	}
+	if (lexed){
+		//Errors were reported while recording, so the
+		// replay carries only the tokens
+		return new Scanner(new TokenReplay(&myTokens));
+	}
+	if (myOpts.tokenCacheDir != nullptr){
+		//The cache keeps lexical errors in the stream, so the
+		// Scanner reports them just as it would from a lexer
+		if (myCache == nullptr){
+			myCache = TokenCache::get(myOpts.tokenCacheDir, mySource);
+		}
+		return new Scanner(myCache->stream());
+	}
+	if (myOpts.lexPool != nullptr){
+		//A few chunks per thread evens out the load
+		size_t chunks = myOpts.lexPool->size() * 4;
+		return new Scanner(
+			new ChunkedLexer(mySource, myOpts.lexPool, chunks));
+	}
+	if (myOpts.usePipeline){
+		return new Scanner(new PipelinedLexer(
+			new SimdLexer(mySource)));
+	}
+	if (myOpts.useSimdLexer){
+		return new Scanner(new SimdLexer(mySource));
+	}
+	return new Scanner(mySource);
+}
+
+const std::vector<RawToken>& Compilation::tokens(){
+	if (!lexed){
+		ArenaScope scope(&myArena);
+		SourceScope sources(&mySourceMgr);
+		//Held by a unique_ptr so that the lexer (and any
+		// thread it runs) goes away even if a diagnostic
+		// ends the compilation part way through
+		std::unique_ptr<Scanner> scanner(makeScanner());
+		scanner->recordTokens(myTokens);
+		lexed = true;
+	}
+	return myTokens;
+}
+
+void Compilation::outputTokens(OutBuffer& out){
+	tokens();
+	SourceScope sources(&mySourceMgr);
+	Scanner scanner(new TokenReplay(&myTokens));
+	scanner.outputTokens(out);
+}
+
+bool Compilation::runParser(ProgramNode ** root, 
+  const ParseOptions& parseOpts){
+	ArenaScope scope(&myArena);
+	SourceScope sources(&mySourceMgr);
+	//If the file has been through the parser before, anything
+	// this parse could report has been reported once already
+	DiagnosticEngine repeats;
+	std::unique_ptr<DiagnosticScope> quiet;
+	if (recognized){ quiet.reset(new DiagnosticScope(&repeats)); }
+	std::unique_ptr<Scanner> scanner(makeScanner());
+	Parser parser(*scanner, root, parseOpts);
+	accepted = parser.parse() == 0;
+	recognized = true;
+	return accepted;
+}
+
+ProgramNode * Compilation::ast(){
+	if (!parsed){
+		//If the file is already known not to parse, there is
+		// no AST to be had, and the errors saying so have been
+		// reported
+		if (recognized && !accepted){
+			myAST = nullptr;
+		} else if (!runParser(&myAST, ParseOptions())){
+			myAST = nullptr;
+		}
+		parsed = true;
+	}
+	return myAST;
+}
+
+bool Compilation::recognize(){
+	if (parsed){ return myAST != nullptr; }
+	if (!recognized){
+		ProgramNode * noRoot = nullptr;
+		ParseOptions recognizeOnly;
+		recognizeOnly.buildAST = false;
+		runParser(&noRoot, recognizeOnly);
+	}
+	return accepted;
+}
+
+bool Compilation::streamUnparse(OutBuffer& out){
+	if (parsed){
+		if (myAST == nullptr){ return false; }
+		myAST->unparse(out, 0);
+		return true;
+	}
+	if (recognized && !accepted){ return false; }
+	ProgramNode * noRoot = nullptr;
+	StreamingUnparser unparser(out, &myArena);
+	ParseOptions streaming;
+	streaming.stream = &unparser;
+	return runParser(&noRoot, streaming);
+}
+
+NameAnalysis * Compilation::names(){
+	if (!named){
+		ProgramNode * root = ast();
+		ArenaScope scope(&myArena);
+		SourceScope sources(&mySourceMgr);
+		if (root == nullptr){
+			myNames = nullptr;
+		} else if (myOpts.useScopeChain){
+			myNames = NameAnalysis::build(root,
+				new ScopeChainTable());
+		} else {
+			myNames = NameAnalysis::build(root);
+		}
+		named = true;
+	}
+	return myNames;
+}
+
+TypeAnalysis * Compilation::types(){
+	if (!typed){
+		NameAnalysis * nameAnalysis = names();
+		ArenaScope scope(&myArena);
+		SourceScope sources(&mySourceMgr);
+		if (nameAnalysis != nullptr){
+			myTypes = TypeAnalysis::build(nameAnalysis);
+		}
+		typed = true;
+	}
+	return myTypes;
+}
+
+}
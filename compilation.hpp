@@ -0,0 +1,116 @@
+#ifndef HOLEYC_COMPILATION_HPP
+#define HOLEYC_COMPILATION_HPP
+
+#include <vector>
+
+#include "arena.hpp"
+#include "source_buffer.hpp"
+#include "source_manager.hpp"
+#include "thread_pool.hpp"
+#include "token_stream.hpp"
+
+namespace holeyc{
+
+class Scanner;
+class OutBuffer;
+class TokenCache;
+struct ParseOptions;
+class ProgramNode;
+class NameAnalysis;
+class TypeAnalysis;
+
+//How the front end should go about its work, as chosen on
+// the command line
+struct CompileOptions{
+	CompileOptions() : useSimdLexer(false), usePipeline(false),
+	  lexPool(nullptr), useScopeChain(false), tokenCacheDir(nullptr){ }
+
+	//Which lexer implementation to use (-l)
+	bool useSimdLexer;
+	bool usePipeline;
+	//Worker threads for chunked lexing (-j), if any
+	ThreadPool * lexPool;
+	//Use the chain of per-scope tables rather than the
+	// scope stack (-s)
+	bool useScopeChain;
+	//Keep the tokens of each file in this directory, and
+	// reuse them while the file is unchanged (-C)
+	const char * tokenCacheDir;
+};
+
+//Everything the front end works out about one source file.
+// Each phase runs at most once, the first time anything asks
+// for its result (or for the result of a later phase), and
+// the result is kept for every later request. However many
+// outputs a run asks for, the file is lexed, parsed and
+// analyzed once, and each diagnostic is reported once.
+//
+//Everything the phases build lives in the compilation's own
+// arena, and is freed along with it. While a phase runs, the
+// compilation's SourceManager is installed, so that tokens
+// and nodes can give their line and column.
+class Compilation{
+public:
+	Compilation(SourceBuffer * sourceIn, const CompileOptions& optsIn)
+	: mySource(sourceIn), mySourceMgr(sourceIn), myOpts(optsIn),
+	  lexed(false), recognized(false), accepted(false),
+	  parsed(false), named(false), typed(false),
+	  myCache(nullptr), myAST(nullptr), myNames(nullptr),
+	  myTypes(nullptr){ }
+	~Compilation();
+	Compilation(const Compilation&) = delete;
+	Compilation& operator=(const Compilation&) = delete;
+
+	//The tokens of the whole file. Lexing up front is only
+	// needed when the tokens themselves are wanted; otherwise
+	// the parser pulls them straight from the lexer, so that
+	// lexical and syntax errors interleave as they always
+	// have.
+	const std::vector<RawToken>& tokens();
+	void outputTokens(OutBuffer& out);
+
+	//The results of each phase, or nullptr if that phase (or
+	// one before it) failed
+	ProgramNode * ast();
+	NameAnalysis * names();
+	TypeAnalysis * types();
+
+	//Whether the file parses, found without building the AST
+	// (see ParseOptions) unless it has been built already. Use
+	// this when nothing else needs the tree: a later ast()
+	// has to parse the file a second time.
+	bool recognize();
+
+	//Unparse the file to out. Unless the AST has been built
+	// already, each global is written and freed as soon as it
+	// is parsed (see StreamingUnparser), so the tree is never
+	// held whole. Returns whether the file parsed; if not, the
+	// globals before the error have been written.
+	bool streamUnparse(OutBuffer& out);
+private:
+	Scanner * makeScanner();
+	bool runParser(ProgramNode ** root, const ParseOptions& parseOpts);
+
+	SourceBuffer * mySource;
+	SourceManager mySourceMgr;
+	CompileOptions myOpts;
+	Arena myArena;
+
+	bool lexed;
+	//Whether the parser has run over the file (in any mode),
+	// and if so whether it accepted it
+	bool recognized;
+	bool accepted;
+	bool parsed;
+	bool named;
+	bool typed;
+	std::vector<RawToken> myTokens;
+	TokenCache * myCache;
+	ProgramNode * myAST;
+	NameAnalysis * myNames;
+	TypeAnalysis * myTypes;
+};
+
+}
+
+#endif
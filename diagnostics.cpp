@@ -0,0 +1,81 @@
+#include <iostream>
+
+#include "diagnostics.hpp"
+
+namespace holeyc{
+
+void DiagnosticEngine::report(Diagnostic diag){
+	bool error = diag.isError();
+	myDiags.push_back(std::move(diag));
+	if (error){
+		myErrors++;
+		if (myMaxErrors != 0 && myErrors >= myMaxErrors){
+			throw new TooManyErrors(myMaxErrors);
+		}
+	}
+}
+
+static void renderPosition(std::string& buf, const char * tag,
+  const Diagnostic& diag){
+	buf += tag;
+	buf += " [";
+	buf += std::to_string(diag.line);
+	buf += ",";
+	buf += std::to_string(diag.col);
+	buf += "]: ";
+	buf += diag.message;
+	buf += "\n";
+}
+
+void DiagnosticEngine::render(std::ostream& out, std::ostream& err){
+	std::string outBuf;
+	std::string errBuf;
+	//With a single stream everything goes into one buffer,
+	// in order
+	std::string& outText = &out == &err ? errBuf : outBuf;
+	for (const Diagnostic& diag : myDiags){
+		switch (diag.severity){
+		case Severity::FATAL:
+			renderPosition(errBuf, "FATAL", diag);
+			break;
+		case Severity::WARNING:
+			renderPosition(errBuf, "*WARNING*", diag);
+			break;
+		case Severity::SYNTAX:
+			outText += diag.message;
+			outText += "\n";
+			errBuf += "syntax error\n";
+			break;
+		case Severity::NOTE:
+			errBuf += diag.message;
+			break;
+		}
+	}
+	myDiags.clear();
+
+	if (!outBuf.empty()){
+		out.write(outBuf.data(), 
+			static_cast<std::streamsize>(outBuf.size()));
+		out.flush();
+	}
+	if (!errBuf.empty()){
+		err.write(errBuf.data(), 
+			static_cast<std::streamsize>(errBuf.size()));
+		err.flush();
+	}
+}
+
+void DiagnosticEngine::emit(Severity severity, DiagCode code,
+  size_t line, size_t col, std::string message){
+	Diagnostic diag{severity, code, line, col, std::move(message)};
+	DiagnosticEngine * engine = installed();
+	if (engine != nullptr){
+		engine->report(std::move(diag));
+		return;
+	}
+	DiagnosticEngine now;
+	now.report(std::move(diag));
+	now.render(std::cout, std::cerr);
+}
+
+}
@@ -0,0 +1,104 @@
+#ifndef HOLEYC_DIAGNOSTICS_HPP
+#define HOLEYC_DIAGNOSTICS_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace holeyc{
+
+enum class Severity{
+	FATAL,		// "FATAL [l,c]: message"
+	WARNING,	// "*WARNING* [l,c]: message"
+	SYNTAX,		// The parser's message on stdout, and
+			// "syntax error" on stderr
+	NOTE		// The message as is, on stderr
+};
+
+//Which part of the compiler raised a diagnostic
+enum class DiagCode{
+	NONE, LEXICAL, SYNTAX, NAME, TYPE, DRIVER
+};
+
+struct Diagnostic{
+	Severity severity;
+	DiagCode code;
+	size_t line;
+	size_t col;
+	std::string message;
+
+	//Whether this counts towards -fmax-errors
+	bool isError() const {
+		return severity == Severity::FATAL 
+		  || severity == Severity::SYNTAX;
+	}
+};
+
+//Thrown (by pointer, like the other compiler errors) when a
+// diagnostic takes the error count to the limit
+class TooManyErrors{
+public:
+	TooManyErrors(size_t limitIn) : myLimit(limitIn){ }
+	size_t limit() const { return myLimit; }
+private:
+	size_t myLimit;
+};
+
+//Collects the diagnostics reported on a thread while it is
+// installed there (see DiagnosticScope), instead of each one
+// being written and flushed as it is raised. Rendering turns
+// the records into exactly the text Report used to print
+// immediately, but with one write per stream.
+class DiagnosticEngine{
+public:
+	DiagnosticEngine() : myMaxErrors(0), myErrors(0){ }
+
+	//Give up, by throwing TooManyErrors, once max errors have
+	// been reported. 0 (the default) means no limit.
+	void setMaxErrors(size_t max){ myMaxErrors = max; }
+
+	void report(Diagnostic diag);
+	size_t errorCount() const { return myErrors; }
+	const std::vector<Diagnostic>& diagnostics() const {
+		return myDiags;
+	}
+
+	//Write out everything collected so far, in the order it
+	// was reported, and clear it. out gets the parser's
+	// messages (std::cout in a normal run) and err the rest.
+	// If they are the same stream, the two stay interleaved.
+	void render(std::ostream& out, std::ostream& err);
+
+	//Hand a diagnostic to the engine installed on this
+	// thread, or print it straight away if there is none
+	static void emit(Severity severity, DiagCode code,
+	  size_t line, size_t col, std::string message);
+	static DiagnosticEngine * current(){ return installed(); }
+private:
+	friend class DiagnosticScope;
+	static DiagnosticEngine *& installed(){
+		static thread_local DiagnosticEngine * theEngine = nullptr;
+		return theEngine;
+	}
+
+	std::vector<Diagnostic> myDiags;
+	size_t myMaxErrors;
+	size_t myErrors;
+};
+
+//Installs an engine on the current thread for its lifetime
+class DiagnosticScope{
+public:
+	DiagnosticScope(DiagnosticEngine * engine)
+	: myPrev(DiagnosticEngine::installed()){
+		DiagnosticEngine::installed() = engine;
+	}
+	~DiagnosticScope(){ DiagnosticEngine::installed() = myPrev; }
+private:
+	DiagnosticEngine * myPrev;
+};
+
+}
+
+#endif
@@ -8,15 +8,15 @@ namespace holeyc{
 class NameErr{
 public:
 static bool undeclID(size_t line, size_t col){
-	Report::fatal(line, col, "Undeclared identifier");
+	Report::fatal(DiagCode::NAME, line, col, "Undeclared identifier");
 	return false;
 }
 static bool badVarType(size_t line, size_t col){
-	Report::fatal(line, col, "Invalid type in declaration");
+	Report::fatal(DiagCode::NAME, line, col, "Invalid type in declaration");
 	return false;
 }
 static bool multiDecl(size_t line, size_t col){
-	Report::fatal(line, col, "Multiply declared identifier");
+	Report::fatal(DiagCode::NAME, line, col, "Multiply declared identifier");
 	return false;
 }
 };
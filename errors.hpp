@@ -7,6 +7,7 @@
 #define TODO(x) throw new ToDoError(CODELOC #x);
 
 #include <iostream>
+#include "diagnostics.hpp"
 
 namespace holeyc{
 
@@ -26,40 +27,56 @@ private:
 	const char * myMsg;
 };
 
+//Every diagnostic goes through here. It is handed to the
+// DiagnosticEngine installed on the current thread, if there
+// is one, and otherwise printed straight away.
 class Report{
 public:
 	static void fatal(
+		DiagCode code,
 		size_t l, 
 		size_t c, 
-		const char * msg
+		const std::string& msg
 	){
-		std::cerr << "FATAL [" << l << "," << c << "]: " 
-		<< msg  << std::endl;
+		DiagnosticEngine::emit(Severity::FATAL, code, l, c, msg);
 	}
 
 	static void fatal(
 		size_t l, 
 		size_t c, 
-		const std::string msg
+		const std::string& msg
 	){
-		fatal(l,c,msg.c_str());
+		fatal(DiagCode::NONE, l, c, msg);
 	}
 
 	static void warn(
+		DiagCode code,
 		size_t l,
 		size_t c,
-		const char * msg
+		const std::string& msg
 	){
-		std::cerr << "*WARNING* [" << l << "," << c << "]: " 
-		<< msg  << std::endl;
+		DiagnosticEngine::emit(Severity::WARNING, code, l, c, msg);
 	}
 
 	static void warn(
 		size_t l,
 		size_t c,
-		const std::string msg
+		const std::string& msg
 	){
-		warn(l,c,msg.c_str());
+		warn(DiagCode::NONE, l, c, msg);
+	}
+
+	//A syntax error, as worded by the parser
+	static void syntax(const std::string& msg){
+		DiagnosticEngine::emit(Severity::SYNTAX, DiagCode::SYNTAX,
+			0, 0, msg);
+	}
+
+	//Free-form text for stderr (such as the driver's
+	// summary lines), kept in order with the diagnostics
+	static void note(const std::string& text){
+		DiagnosticEngine::emit(Severity::NOTE, DiagCode::DRIVER,
+			0, 0, text);
 	}
 };
 
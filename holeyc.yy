@@ -1,10 +1,11 @@
 %skeleton "lalr1.cc"
-%require "3.0"
+%require "3.2"
 %debug
 %defines
 %define api.namespace{holeyc}
 %define api.parser.class {Parser}
 %define parse.error verbose
+%define api.value.type variant
 %output "parser.cc"
 %token-table
 
@@ -14,6 +15,27 @@
 	#include "ast.hpp"
 	namespace holeyc {
 		class Scanner;
+
+		class StreamingUnparser;
+
+		//What the parse should produce. With buildAST off,
+		// the parser only recognizes the input: no action
+		// runs, nothing is allocated per production, every
+		// nonterminal's value stays nullptr, and all that
+		// comes out is whether the input was accepted (plus
+		// any syntax errors, reported as usual).
+		//
+		//With a stream, each global declaration is handed to
+		// it as soon as it is reduced, instead of being kept
+		// for a ProgramNode (no root is produced).
+		struct ParseOptions{
+			ParseOptions() : buildAST(true), stream(nullptr){ }
+			bool keepGlobals() const {
+				return buildAST && stream == nullptr;
+			}
+			bool buildAST;
+			StreamingUnparser * stream;
+		};
 	}
 
 //The following definition is required when 
@@ -31,6 +53,7 @@
 
 %parse-param { holeyc::Scanner &scanner }
 %parse-param { holeyc::ProgramNode** root }
+%parse-param { holeyc::ParseOptions opts }
 
 %code{
    // C std code for utility functions
@@ -49,101 +72,75 @@
   #define yylex scanner.yylex
 }
 
-%union {
-   bool                                  transBool;
-   holeyc::Token*                         transToken;
-   holeyc::IDToken*                       transIDToken;
-   holeyc::IntLitToken*                   transIntToken;
-   holeyc::StrToken*                      transStrToken;
-   holeyc::CharLitToken*                  transCharToken;
-   holeyc::ProgramNode*                   transProgram;
-   std::list<holeyc::DeclNode *> *        transDeclList;
-   holeyc::DeclNode *                     transDecl;
-   holeyc::VarDeclNode *                  transVarDecl;
-   std::list<holeyc::FormalDeclNode *> *  transFormals;
-   holeyc::FormalDeclNode *               transFormal;
-   holeyc::TypeNode *                     transType;
-   holeyc::LValNode *                     transLVal;
-   holeyc::IDNode *                       transID;
-   holeyc::FnDeclNode *                   transFn;
-   std::list<holeyc::VarDeclNode *> *     transVarDecls;
-   std::list<holeyc::StmtNode *> *        transStmts;
-   holeyc::StmtNode *                     transStmt;
-   holeyc::ExpNode *                      transExp;
-   holeyc::AssignExpNode *                transAssignExp;
-   holeyc::CallExpNode *                  transCallExp;
-   std::list<holeyc::ExpNode *> *         transActuals;
-}
-
 %define parse.assert
 
 %token                   END	   0 "end file"
-%token	<transToken>     AND
-%token	<transToken>     AT
-%token	<transToken>     ASSIGN
-%token	<transToken>     BOOL
-%token	<transToken>     BOOLPTR
-%token	<transToken>     CARAT
-%token	<transToken>     CHAR
-%token	<transCharToken> CHARLIT
-%token	<transToken>     CHARPTR
-%token	<transToken>     COMMA
-%token	<transToken>     CROSS
-%token	<transToken>     CROSSCROSS
-%token	<transToken>     DASH
-%token	<transToken>     DASHDASH
-%token	<transToken>     ELSE
-%token	<transToken>     EQUALS
-%token	<transToken>     FALSE
-%token	<transToken>     FROMCONSOLE
-%token	<transIDToken>   ID
-%token	<transToken>     IF
-%token	<transToken>     INT
-%token	<transIntToken>  INTLITERAL
-%token	<transToken>     INTPTR
-%token	<transToken>     GREATER
-%token	<transToken>     GREATEREQ
-%token	<transToken>     LBRACE
-%token	<transToken>     LCURLY
-%token	<transToken>     LESS
-%token	<transToken>     LESSEQ
-%token	<transToken>     LPAREN
-%token	<transToken>     NOT
-%token	<transToken>     NOTEQUALS
-%token	<transToken>     NULLPTR
-%token	<transToken>     OR
-%token	<transToken>     RBRACE
-%token	<transToken>     RCURLY
-%token	<transToken>     RETURN
-%token	<transToken>     RPAREN
-%token	<transToken>     SEMICOLON
-%token	<transToken>     SLASH
-%token	<transToken>     STAR
-%token	<transStrToken>  STRLITERAL
-%token	<transToken>     TOCONSOLE
-%token	<transToken>     TRUE
-%token	<transToken>     VOID
-%token	<transToken>     WHILE
-
-%type <transProgram>    program
-%type <transDeclList>   globals
-%type <transDecl>       decl
-%type <transVarDecl>    varDecl
-%type <transType>       type
-%type <transLVal>       lval
-%type <transID>         id
-%type <transFn>         fnDecl
-%type <transFormals>    formals
-%type <transFormals>    formalsList
-%type <transFormal>     formalDecl
-%type <transStmts>      fnBody
-%type <transStmts>      stmtList
-%type <transStmt>       stmt
-%type <transAssignExp>  assignExp
-%type <transExp>        exp
-%type <transExp>        term
-%type <transCallExp>    callExp
-%type <transActuals>    actualsList
+%token	<holeyc::Token>         AND
+%token	<holeyc::Token>         AT
+%token	<holeyc::Token>         ASSIGN
+%token	<holeyc::Token>         BOOL
+%token	<holeyc::Token>         BOOLPTR
+%token	<holeyc::Token>         CARAT
+%token	<holeyc::Token>         CHAR
+%token	<holeyc::CharLitToken>  CHARLIT
+%token	<holeyc::Token>         CHARPTR
+%token	<holeyc::Token>         COMMA
+%token	<holeyc::Token>         CROSS
+%token	<holeyc::Token>         CROSSCROSS
+%token	<holeyc::Token>         DASH
+%token	<holeyc::Token>         DASHDASH
+%token	<holeyc::Token>         ELSE
+%token	<holeyc::Token>         EQUALS
+%token	<holeyc::Token>         FALSE
+%token	<holeyc::Token>         FROMCONSOLE
+%token	<holeyc::IDToken>       ID
+%token	<holeyc::Token>         IF
+%token	<holeyc::Token>         INT
+%token	<holeyc::IntLitToken>   INTLITERAL
+%token	<holeyc::Token>         INTPTR
+%token	<holeyc::Token>         GREATER
+%token	<holeyc::Token>         GREATEREQ
+%token	<holeyc::Token>         LBRACE
+%token	<holeyc::Token>         LCURLY
+%token	<holeyc::Token>         LESS
+%token	<holeyc::Token>         LESSEQ
+%token	<holeyc::Token>         LPAREN
+%token	<holeyc::Token>         NOT
+%token	<holeyc::Token>         NOTEQUALS
+%token	<holeyc::Token>         NULLPTR
+%token	<holeyc::Token>         OR
+%token	<holeyc::Token>         RBRACE
+%token	<holeyc::Token>         RCURLY
+%token	<holeyc::Token>         RETURN
+%token	<holeyc::Token>         RPAREN
+%token	<holeyc::Token>         SEMICOLON
+%token	<holeyc::Token>         SLASH
+%token	<holeyc::Token>         STAR
+%token	<holeyc::StrToken>      STRLITERAL
+%token	<holeyc::Token>         TOCONSOLE
+%token	<holeyc::Token>         TRUE
+%token	<holeyc::Token>         VOID
+%token	<holeyc::Token>         WHILE
+
+%type <holeyc::ProgramNode *>                            program
+%type <holeyc::ArenaVector<holeyc::DeclNode *> *>        globals
+%type <holeyc::DeclNode *>                               decl
+%type <holeyc::VarDeclNode *>                            varDecl
+%type <holeyc::TypeNode *>                               type
+%type <holeyc::LValNode *>                               lval
+%type <holeyc::IDNode *>                                 id
+%type <holeyc::FnDeclNode *>                             fnDecl
+%type <holeyc::ArenaVector<holeyc::FormalDeclNode *> *>  formals
+%type <holeyc::ArenaVector<holeyc::FormalDeclNode *> *>  formalsList
+%type <holeyc::FormalDeclNode *>                         formalDecl
+%type <holeyc::ArenaVector<holeyc::StmtNode *> *>        fnBody
+%type <holeyc::ArenaVector<holeyc::StmtNode *> *>        stmtList
+%type <holeyc::StmtNode *>                               stmt
+%type <holeyc::AssignExpNode *>                          assignExp
+%type <holeyc::ExpNode *>                                exp
+%type <holeyc::ExpNode *>                                term
+%type <holeyc::CallExpNode *>                            callExp
+%type <holeyc::ArenaVector<holeyc::ExpNode *> *>         actualsList
 
 /* NOTE: Make sure to add precedence and associativity 
  * declarations
@@ -161,19 +158,27 @@
 
 program 	: globals
 		  {
-		  $$ = new ProgramNode($1);
-		  *root = $$;
+		  if (opts.keepGlobals()){
+		  	$$ = new ProgramNode($1->span());
+		  	*root = $$;
+		  }
 		  }
 
 globals 	: globals decl 
-	  	  { 
-	  	  $$ = $1; 
-	  	  DeclNode * declNode = $2;
-		  $$->push_back(declNode);
-	  	  }
+		  {
+		  if (opts.keepGlobals()){
+		  	$$ = $1; 
+		  	DeclNode * declNode = $2;
+		  	$$->push_back(declNode);
+		  } else if (opts.buildAST){
+		  	opts.stream->emit($2);
+		  }
+		  }
 		| /* epsilon */
 		  {
-		  $$ = new std::list<DeclNode * >();
+		  if (opts.keepGlobals()){
+		  	$$ = new ArenaVector<DeclNode *>();
+		  }
 		  }
 
 decl 		: varDecl SEMICOLON
@@ -183,49 +188,67 @@ decl 		: varDecl SEMICOLON
 
 varDecl 	: type id
 		  {
-		  size_t line = $1->line();
-		  size_t col = $1->col();
-		  $$ = new VarDeclNode(line, col, $1, $2);
+		  if (opts.buildAST){
+		  	$$ = new VarDeclNode($1->offset(), $1, $2);
+		  }
 		  }
 
 type 		: INT
-	  	  { 
-		  $$ = new IntTypeNode($1->line(), $1->col(), false);
+	  	  {
+		  if (opts.buildAST){
+		  	$$ = new IntTypeNode($1.offset(), false);
+		  }
 		  }
 		| INTPTR
-	  	  { 
-		  $$ = new IntTypeNode($1->line(), $1->col(), true);
+	  	  {
+		  if (opts.buildAST){
+		  	$$ = new IntTypeNode($1.offset(), true);
+		  }
 		  }
 		| BOOL
 		  {
-		  $$ = new BoolTypeNode($1->line(), $1->col(), false);
+		  if (opts.buildAST){
+		  	$$ = new BoolTypeNode($1.offset(), false);
+		  }
 		  }
 		| BOOLPTR
 		  {
-		  $$ = new BoolTypeNode($1->line(), $1->col(), true);
+		  if (opts.buildAST){
+		  	$$ = new BoolTypeNode($1.offset(), true);
+		  }
 		  }
 		| CHAR
 		  {
-		  $$ = new CharTypeNode($1->line(), $1->col(), false);
+		  if (opts.buildAST){
+		  	$$ = new CharTypeNode($1.offset(), false);
+		  }
 		  }
 		| CHARPTR
 		  {
-		  $$ = new CharTypeNode($1->line(), $1->col(), true);
+		  if (opts.buildAST){
+		  	$$ = new CharTypeNode($1.offset(), true);
+		  }
 		  }
 		| VOID
 		  {
-		  $$ = new VoidTypeNode($1->line(), $1->col());
+		  if (opts.buildAST){
+		  	$$ = new VoidTypeNode($1.offset());
+		  }
 		  }
 
 fnDecl 		: type id formals fnBody
 		  {
-		  $$ = new FnDeclNode($1->line(), $1->col(), 
-		    $1, $2, $3, $4);
+		  if (opts.buildAST){
+		  	$$ = new FnDeclNode($1->offset(), 
+		  	  $1, $2, $3->span(), $4->span());
+		  }
 		  }
 
 formals 	: LPAREN RPAREN
 		  {
-		  $$ = new std::list<FormalDeclNode *>();
+		  if (opts.buildAST){
+		  	$$ = new ArenaVector<FormalDeclNode *>();
+		  }
 		  }
 		| LPAREN formalsList RPAREN
 		  {
@@ -235,19 +258,25 @@ formals 	: LPAREN RPAREN
 
 formalsList	: formalDecl
 		  {
-		  $$ = new std::list<FormalDeclNode *>();
-		  $$->push_back($1);
+		  if (opts.buildAST){
+		  	$$ = new ArenaVector<FormalDeclNode *>();
+		  	$$->push_back($1);
+		  }
 		  }
-		| formalDecl COMMA formalsList 
+		| formalsList COMMA formalDecl
 		  {
-		  $$ = $3;
-		  $$->push_front($1);
+		  if (opts.buildAST){
+		  	$$ = $1;
+		  	$$->push_back($3);
+		  }
 		  }
 
 formalDecl 	: type id
 		  {
-		  $$ = new FormalDeclNode($1->line(), $1->col(), 
-		    $1, $2);
+		  if (opts.buildAST){
+		  	$$ = new FormalDeclNode($1->offset(), 
+		  	  $1, $2);
+		  }
 		  }
 
 fnBody		: LCURLY stmtList RCURLY
@@ -256,15 +285,18 @@ fnBody		: LCURLY stmtList RCURLY
 		  }
 
 stmtList 	: /* epsilon */
-	   	  {
-		  $$ = new std::list<StmtNode *>();
-		  //$$->push_back($1);
-	   	  }
+		  {
+		  if (opts.buildAST){
+		  	$$ = new ArenaVector<StmtNode *>();
+		  }
+		  }
 		| stmtList stmt
-	  	  {
-		  $$ = $1;
-		  $$->push_back($2);
-	  	  }
+		  {
+		  if (opts.buildAST){
+		  	$$ = $1;
+		  	$$->push_back($2);
+		  }
+		  }
 
 stmt		: varDecl SEMICOLON
 		  {
@@ -272,136 +304,199 @@ stmt		: varDecl SEMICOLON
 		  }
 		| assignExp SEMICOLON
 		  {
-		  $$ = new AssignStmtNode($1->line(), $1->col(), $1); 
+		  if (opts.buildAST){
+		  	$$ = new AssignStmtNode($1->offset(), $1); 
+		  }
 		  }
 		| lval DASHDASH SEMICOLON
 		  {
-		  $$ = new PostDecStmtNode($2->line(), $2->col(), $1);
+		  if (opts.buildAST){
+		  	$$ = new PostDecStmtNode($2.offset(), $1);
+		  }
 		  }
 		| lval CROSSCROSS SEMICOLON
 		  {
-		  $$ = new PostIncStmtNode($2->line(), $2->col(), $1);
+		  if (opts.buildAST){
+		  	$$ = new PostIncStmtNode($2.offset(), $1);
+		  }
 		  }
 		| FROMCONSOLE lval SEMICOLON
 		  {
-		  $$ = new FromConsoleStmtNode($1->line(), $1->col(), $2);
+		  if (opts.buildAST){
+		  	$$ = new FromConsoleStmtNode($1.offset(), $2);
+		  }
 		  }
 		| TOCONSOLE exp SEMICOLON
 		  {
-		  $$ = new ToConsoleStmtNode($1->line(), $1->col(), $2);
+		  if (opts.buildAST){
+		  	$$ = new ToConsoleStmtNode($1.offset(), $2);
+		  }
 		  }
 		| IF LPAREN exp RPAREN LCURLY stmtList RCURLY
 		  {
-		  $$ = new IfStmtNode($1->line(), $1->col(), $3, $6);
+		  if (opts.buildAST){
+		  	$$ = new IfStmtNode($1.offset(), $3, $6->span());
+		  }
 		  }
 		| IF LPAREN exp RPAREN LCURLY stmtList RCURLY ELSE LCURLY stmtList RCURLY
 		  {
-		  $$ = new IfElseStmtNode($1->line(), $1->col(), $3, 
-		    $6, $10);
+		  if (opts.buildAST){
+		  	$$ = new IfElseStmtNode($1.offset(), $3, 
+		  	  $6->span(), $10->span());
+		  }
 		  }
 		| WHILE LPAREN exp RPAREN LCURLY stmtList RCURLY
 		  {
-		  $$ = new WhileStmtNode($1->line(), $1->col(), $3, $6);
+		  if (opts.buildAST){
+		  	$$ = new WhileStmtNode($1.offset(), $3, 
+		  	  $6->span());
+		  }
 		  }
 		| RETURN exp SEMICOLON
 		  {
-		  $$ = new ReturnStmtNode($1->line(), $1->col(), $2);
+		  if (opts.buildAST){
+		  	$$ = new ReturnStmtNode($1.offset(), $2);
+		  }
 		  }
 		| RETURN SEMICOLON
 		  {
-		  $$ = new ReturnStmtNode($1->line(), $1->col(), nullptr);
+		  if (opts.buildAST){
+		  	$$ = new ReturnStmtNode($1.offset(), nullptr);
+		  }
 		  }
 		| callExp SEMICOLON
-		  { $$ = new CallStmtNode($1->line(), $1->col(), $1); }
+		  {
+		  if (opts.buildAST){
+		  	$$ = new CallStmtNode($1->offset(), $1);
+		  }
+		  }
 
 exp		: assignExp 
 		  { $$ = $1; } 
 		| exp DASH exp
 	  	  {
-		  $$ = new MinusNode($2->line(), $2->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new MinusNode($2.offset(), $1, $3);
+		  }
 		  }
 		| exp CROSS exp
 	  	  {
-		  $$ = new PlusNode($2->line(), $2->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new PlusNode($2.offset(), $1, $3);
+		  }
 		  }
 		| exp STAR exp
 	  	  {
-		  $$ = new TimesNode($2->line(), $2->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new TimesNode($2.offset(), $1, $3);
+		  }
 		  }
 		| exp SLASH exp
 	  	  {
-		  $$ = new DivideNode($2->line(), $2->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new DivideNode($2.offset(), $1, $3);
+		  }
 		  }
 		| exp AND exp
 	  	  {
-		  $$ = new AndNode($2->line(), $2->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new AndNode($2.offset(), $1, $3);
+		  }
 		  }
 		| exp OR exp
 	  	  {
-		  $$ = new OrNode($2->line(), $2->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new OrNode($2.offset(), $1, $3);
+		  }
 		  }
 		| exp EQUALS exp
 	  	  {
-		  $$ = new EqualsNode($2->line(), $2->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new EqualsNode($2.offset(), $1, $3);
+		  }
 		  }
 		| exp NOTEQUALS exp
 	  	  {
-		  $$ = new NotEqualsNode($2->line(), $2->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new NotEqualsNode($2.offset(), $1, $3);
+		  }
 		  }
 		| exp GREATER exp
 	  	  {
-		  $$ = new GreaterNode($2->line(), $2->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new GreaterNode($2.offset(), $1, $3);
+		  }
 		  }
 		| exp GREATEREQ exp
 	  	  {
-		  $$ = new GreaterEqNode($2->line(), $2->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new GreaterEqNode($2.offset(), $1, $3);
+		  }
 		  }
 		| exp LESS exp
 	  	  {
-		  $$ = new LessNode($2->line(), $2->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new LessNode($2.offset(), $1, $3);
+		  }
 		  }
 		| exp LESSEQ exp
 	  	  {
-		  $$ = new LessEqNode($2->line(), $2->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new LessEqNode($2.offset(), $1, $3);
+		  }
 		  }
 		| NOT exp
 	  	  {
-		  $$ = new NotNode($1->line(), $1->col(), $2);
+		  if (opts.buildAST){
+		  	$$ = new NotNode($1.offset(), $2);
+		  }
 		  }
 		| DASH term
 	  	  {
-		  $$ = new NegNode($1->line(), $1->col(), $2);
+		  if (opts.buildAST){
+		  	$$ = new NegNode($1.offset(), $2);
+		  }
 		  }
 		| term 
 	  	  { $$ = $1; }
 
 assignExp	: lval ASSIGN exp
 		  {
-		  $$ = new AssignExpNode($2->line(), $2->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new AssignExpNode($2.offset(), $1, $3);
+		  }
 		  }
 
 callExp		: id LPAREN RPAREN
 		  {
-		  std::list<ExpNode *> * noargs =
-		    new std::list<ExpNode *>();
-		  $$ = new CallExpNode($1->line(), $1->col(), $1, noargs);
+		  if (opts.buildAST){
+		  	Span<ExpNode *> noargs;
+		  	$$ = new CallExpNode($1->offset(), $1, noargs);
+		  }
 		  }
 		| id LPAREN actualsList RPAREN
 		  {
-		  $$ = new CallExpNode($1->line(), $1->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new CallExpNode($1->offset(), $1, 
+		  	  $3->span());
+		  }
 		  }
 
 actualsList	: exp
 		  {
-		  std::list<ExpNode *> * list =
-		    new std::list<ExpNode *>();
-		  list->push_back($1);
-		  $$ = list;
+		  if (opts.buildAST){
+		  	ArenaVector<ExpNode *> * list =
+		  	  new ArenaVector<ExpNode *>();
+		  	list->push_back($1);
+		  	$$ = list;
+		  }
 		  }
 		| actualsList COMMA exp
 		  {
-		  $$ = $1;
-		  $$->push_back($3);
+		  if (opts.buildAST){
+		  	$$ = $1;
+		  	$$->push_back($3);
+		  }
 		  }
 
 term 		: lval
@@ -412,18 +507,41 @@ term 		: lval
 		  }
 		| NULLPTR
 		  {
-		  $$ = new NullPtrNode($1->line(), $1->col());
+		  if (opts.buildAST){
+		  	$$ = new NullPtrNode($1.offset());
+		  }
 		  }
 		| INTLITERAL 
-		  { $$ = new IntLitNode($1->line(), $1->col(), $1->num()); }
+		  {
+		  if (opts.buildAST){
+		  	$$ = new IntLitNode($1.offset(), $1.num());
+		  }
+		  }
 		| STRLITERAL 
-		  { $$ = new StrLitNode($1->line(), $1->col(), $1->str()); }
+		  {
+		  if (opts.buildAST){
+		  	$$ = new StrLitNode($1.offset(), 
+		  	  $1.text(), $1.length());
+		  }
+		  }
 		| CHARLIT 
-		  { $$ = new CharLitNode($1->line(), $1->col(), $1->val()); }
+		  {
+		  if (opts.buildAST){
+		  	$$ = new CharLitNode($1.offset(), $1.val());
+		  }
+		  }
 		| TRUE
-		  { $$ = new TrueNode($1->line(), $1->col()); }
+		  {
+		  if (opts.buildAST){
+		  	$$ = new TrueNode($1.offset());
+		  }
+		  }
 		| FALSE
-		  { $$ = new FalseNode($1->line(), $1->col()); }
+		  {
+		  if (opts.buildAST){
+		  	$$ = new FalseNode($1.offset());
+		  }
+		  }
 		| LPAREN exp RPAREN
 		  { $$ = $2; }
 
@@ -433,25 +551,32 @@ lval		: id
 		  }
 		| id LBRACE exp RBRACE
 		  {
-		  $$ = new IndexNode($1->line(), $1->col(), $1, $3);
+		  if (opts.buildAST){
+		  	$$ = new IndexNode($1->offset(), $1, $3);
+		  }
 		  }
 		| AT id
 		  {
-		  $$ = new DerefNode($1->line(), $1->col(), $2);
+		  if (opts.buildAST){
+		  	$$ = new DerefNode($1.offset(), $2);
+		  }
 		  }
 		| CARAT id
 		  {
-		  $$ = new RefNode($1->line(), $1->col(), $2);
+		  if (opts.buildAST){
+		  	$$ = new RefNode($1.offset(), $2);
+		  }
 		  }
 
 id		: ID
 		  {
-		  $$ = new IDNode($1->line(), $1->col(), $1->value()); 
+		  if (opts.buildAST){
+		  	$$ = new IDNode($1.offset(), $1.name()); 
+		  }
 		  }
 	
 %%
 
 void holeyc::Parser::error(const std::string& msg){
-	std::cout << msg << std::endl;
-	std::cerr << "syntax error" << std::endl;
+	holeyc::Report::syntax(msg);
 }
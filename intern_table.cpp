@@ -0,0 +1,59 @@
+#include <string.h>
+
+#include "intern_table.hpp"
+#include "errors.hpp"
+
+namespace holeyc{
+
+InternTable * InternTable::global(){
+	static InternTable * table = new InternTable();
+	return table;
+}
+
+//64-bit FNV-1a
+static size_t hashName(const char * text, size_t len){
+	uint64_t h = 14695981039346656037ULL;
+	for (size_t i = 0; i < len; i++){
+		h ^= static_cast<unsigned char>(text[i]);
+		h *= 1099511628211ULL;
+	}
+	return static_cast<size_t>(h);
+}
+
+bool InternTable::KeyEq::operator()(const Key& a, const Key& b) const{
+	return a.len == b.len && memcmp(a.text, b.text, a.len) == 0;
+}
+
+NameID InternTable::intern(const char * text, size_t len){
+	size_t hash = hashName(text, len);
+	//The low bits pick the bucket inside the shard's map,
+	// so choose the shard with the high ones
+	size_t shardIdx = (hash >> (sizeof(size_t) * 8 - SHARD_BITS));
+	Shard& shard = myShards[shardIdx];
+
+	std::lock_guard<std::mutex> guard(shard.lock);
+	Key key = {text, len, hash};
+	auto found = shard.ids.find(key);
+	if (found != shard.ids.end()){
+		return found->second;
+	}
+
+	size_t index = shard.names.size();
+	if (index >= (size_t(1) << (32 - SHARD_BITS))){
+		throw new InternalError("Too many distinct identifiers");
+	}
+	shard.names.emplace_back(text, len);
+	const std::string& owned = shard.names.back();
+	NameID id = static_cast<NameID>((index << SHARD_BITS) | shardIdx);
+	Key ownedKey = {owned.data(), len, hash};
+	shard.ids.emplace(ownedKey, id);
+	return id;
+}
+
+const std::string& InternTable::name(NameID id){
+	Shard& shard = myShards[id & (NUM_SHARDS - 1)];
+	std::lock_guard<std::mutex> guard(shard.lock);
+	return shard.names[id >> SHARD_BITS];
+}
+
+}
@@ -0,0 +1,62 @@
+#ifndef HOLEYC_INTERN_TABLE_HPP
+#define HOLEYC_INTERN_TABLE_HPP
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace holeyc{
+
+//A small integer standing for an identifier's spelling. Two
+// identifiers have the same NameID exactly when they are
+// spelled the same, so later phases can compare and hash
+// names without touching the characters.
+using NameID = uint32_t;
+
+//Maps identifier spellings to NameIDs and back. The lexers
+// intern every ID as they scan it, possibly from several
+// threads at once, so the table is split into shards, each
+// with its own lock, chosen by the spelling's hash. Names
+// are never removed, and the strings returned by name()
+// stay valid for the life of the program.
+class InternTable{
+public:
+	//The table shared by every scanner in the process
+	static InternTable * global();
+
+	NameID intern(const char * text, size_t len);
+	NameID intern(const std::string& text){
+		return intern(text.data(), text.size());
+	}
+	const std::string& name(NameID id);
+private:
+	static const unsigned SHARD_BITS = 4;
+	static const size_t NUM_SHARDS = size_t(1) << SHARD_BITS;
+
+	//A spelling, pointing either at the text being looked
+	// up or at the copy the shard owns
+	struct Key{
+		const char * text;
+		size_t len;
+		size_t hash;
+	};
+	struct KeyHash{
+		size_t operator()(const Key& k) const { return k.hash; }
+	};
+	struct KeyEq{
+		bool operator()(const Key& a, const Key& b) const;
+	};
+	struct Shard{
+		std::mutex lock;
+		std::unordered_map<Key, NameID, KeyHash, KeyEq> ids;
+		std::deque<std::string> names;
+	};
+
+	Shard myShards[NUM_SHARDS];
+};
+
+}
+
+#endif
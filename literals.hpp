@@ -0,0 +1,58 @@
+#ifndef HOLEYC_LITERALS_HPP
+#define HOLEYC_LITERALS_HPP
+
+#include <climits>
+#include <cstddef>
+
+namespace holeyc{
+
+//Decoding of literal lexemes, shared by the flex rules in
+// holeyc.l and the SimdLexer so that both turn the same text
+// into the same values, each in a single pass over it.
+
+//What each character stands for after a backslash, or 0 if
+// it can't follow one
+struct EscapeTable{
+	constexpr EscapeTable(const char * escapees, const char * values)
+	: myValues(){
+		for (; *escapees != '\0'; escapees++, values++){
+			myValues[static_cast<unsigned char>(*escapees)] = *values;
+		}
+	}
+	constexpr char operator[](char c) const {
+		return myValues[static_cast<unsigned char>(c)];
+	}
+private:
+	char myValues[256];
+};
+
+//In a character literal, a backslash may also be followed by
+// a tab or a space, which stand for themselves
+static constexpr EscapeTable CHAR_ESCAPES("tn\\\t ", "\t\n\\\t ");
+//In a string literal
+static constexpr EscapeTable STRING_ESCAPES("nt'\"\\", "\n\t'\"\\");
+
+//The value of a run of decimal digits. A literal with more
+// than 10 digits, or above INT_MAX, overflows: value is then
+// INT_MAX and the result false. Ten digits can't overflow the
+// accumulator, so the check comes only at the end.
+inline bool decodeInt(const char * digits, size_t len, int * value){
+	if (len > 10){
+		*value = INT_MAX;
+		return false;
+	}
+	long long acc = 0;
+	for (size_t i = 0; i < len; i++){
+		acc = acc * 10 + (digits[i] - '0');
+	}
+	if (acc > INT_MAX){
+		*value = INT_MAX;
+		return false;
+	}
+	*value = static_cast<int>(acc);
+	return true;
+}
+
+}
+
+#endif
@@ -1,8 +1,18 @@
 #include <fstream>
+#include <memory>
+#include <sstream>
 #include <string.h>
+#include <string>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 
 #include "errors.hpp"
-#include "scanner.hpp"
+#include "out_buffer.hpp"
+#include "source_buffer.hpp"
+#include "compilation.hpp"
+#include "work_stealing_pool.hpp"
 #include "ast.hpp"
 #include "name_analysis.hpp"
 #include "type_analysis.hpp"
@@ -10,12 +20,26 @@
 using namespace holeyc;
 
 static void usageAndDie(){
-	std::cerr << "Usage: holeycc <infile> <options>\n"
+	std::cerr << "Usage: holeycc <infile>... <options>\n"
 	<< " [-t <tokensFile>]: Output tokens to <tokensFile>\n"
 	<< " [-p]: Parse the input to check syntax\n"
 	<< " [-u <unparseFile>]: Unparse to <unparseFile>\n"
+	<< " [-U <unparseFile>]: Unparse to <unparseFile> while parsing,\n"
+	<< "   never holding the whole AST\n"
 	<< " [-n <nameFile]: Output name analysis to <namesFile>\n"
 	<< " [-c]: Do type checking\n"
+	<< " [-l <flex|simd|pipe>]: Choose the lexer (default flex);\n"
+	<< "   pipe runs the simd lexer on its own thread\n"
+	<< " [-j <threads>]: Lex in parallel on <threads> threads\n"
+	<< " [-s <stack|chain>]: Choose the symbol table (default stack)\n"
+	<< " [-fmax-errors=<n>]: Stop after <n> errors\n"
+	<< " [-C <dir>]: Cache each file's tokens in <dir>, and reuse\n"
+	<< "   them while the file is unchanged\n"
+	<< " [-m <manifest>]: Also check the files listed in <manifest>,\n"
+	<< "   one path per line\n"
+	<< " [-J <threads>]: Check several input files on <threads>\n"
+	<< "   threads (default: one per core); only -p and -c\n"
+	<< "   apply to more than one file\n"
 	<< "\n"
 	;
 	std::cout << std::flush;
@@ -23,93 +47,208 @@ static void usageAndDie(){
 	exit(1);
 }
 
-static void doTokenization(std::ifstream * input, const char * outPath){
-	holeyc::Scanner scanner(input);
+//Lexer and symbol table choices from the command line
+static holeyc::CompileOptions options;
+//Stop after this many errors (-fmax-errors); 0 for no limit
+static size_t maxErrors = 0;
+
+//Open outPath for one of the bulk outputs, "--" being stdout
+static OutBuffer * openOutput(const char * outPath){
 	if (strcmp(outPath, "--") == 0){
-		scanner.outputTokens(std::cout);
-	} else {
-		std::ofstream outStream(outPath);
-		if (!outStream.good()){
-			std::string msg = "Bad output file ";
-			msg += outPath;
-			throw new holeyc::InternalError(msg.c_str());
-		}
-		scanner.outputTokens(outStream);
+		//Anything already in cout must come out first
+		std::cout << std::flush;
+		return new OutBuffer(STDOUT_FILENO);
 	}
+	OutBuffer * out = OutBuffer::open(outPath);
+	if (out == nullptr){
+		std::string msg = "Bad output file ";
+		msg += outPath;
+		throw new holeyc::InternalError(msg.c_str());
+	}
+	return out;
 }
 
-static holeyc::ProgramNode * syntacticAnalysis(std::ifstream * input){
-	if (input == nullptr){
-		return nullptr;
+static void finishOutput(OutBuffer& out, const char * outPath){
+	if (!out.flush()){
+		std::string msg = "Error writing output file ";
+		msg += outPath;
+		throw new holeyc::InternalError(msg.c_str());
 	}
+}
 
-	holeyc::ProgramNode * root = nullptr;
-
-	holeyc::Scanner scanner(input);
-	#if 1
-	holeyc::Parser parser(scanner, &root);
-	#else
-	holeyc::Parser parser(scanner);
-	#endif
-
-	int errCode = parser.parse();
-	if (errCode != 0) { 
-		return nullptr; 
-	}
-	
-	return root;
+static void doTokenization(Compilation& comp, const char * outPath){
+	std::unique_ptr<OutBuffer> out(openOutput(outPath));
+	comp.outputTokens(*out);
+	finishOutput(*out, outPath);
 }
 
 static void outputAST(ASTNode * ast, const char * outPath){
-	if (strcmp(outPath, "--") == 0){
-		ast->unparse(std::cout, 0);
-	} else {
-		std::ofstream outStream(outPath);
-		if (!outStream.good()){
-			std::string msg = "Bad output file ";
-			msg += outPath;
-			throw new holeyc::InternalError(msg.c_str());
-		}
-		ast->unparse(outStream, 0);
-	}
+	std::unique_ptr<OutBuffer> out(openOutput(outPath));
+	ast->unparse(*out, 0);
+	finishOutput(*out, outPath);
 }
 
-static bool doUnparsing(std::ifstream * input, const char * outPath){
-	holeyc::ProgramNode * ast = syntacticAnalysis(input);
+static bool doUnparsing(Compilation& comp, const char * outPath){
+	holeyc::ProgramNode * ast = comp.ast();
 	if (ast == nullptr){ 
-		std::cerr << "No AST built\n";
+		Report::note("No AST built\n");
 		return false;
 	}
-	if (input == nullptr){ 
-		return false; 
-	}
 
 	outputAST(ast, outPath);
 	return true;
 }
 
-static holeyc::NameAnalysis * doNameAnalysis(std::ifstream * input){
-	holeyc::ProgramNode * ast = syntacticAnalysis(input);
-	if (ast == nullptr){ return nullptr; }
+//Unparse with each global written as soon as it is parsed.
+// If a later output needs the tree anyway, it is built once
+// and unparsed whole instead.
+static bool doStreamUnparsing(Compilation& comp, const char * outPath,
+  bool needAST){
+	std::unique_ptr<OutBuffer> out(openOutput(outPath));
+	if (needAST){ comp.ast(); }
+	bool ok = comp.streamUnparse(*out);
+	finishOutput(*out, outPath);
+	if (!ok){
+		Report::note("Parse failed; unparse output is incomplete\n");
+	}
+	return ok;
+}
 
-	return holeyc::NameAnalysis::build(ast);
+static void reportTooMany(holeyc::TooManyErrors * e){
+	Report::note("compilation terminated due to -fmax-errors="
+		+ std::to_string(e->limit()) + ".\n");
 }
 
-static holeyc::TypeAnalysis * doTypeAnalysis(std::ifstream * input){
-	holeyc::NameAnalysis * nameAnalysis = doNameAnalysis(input);
-	if (nameAnalysis == nullptr){ return nullptr; }
+//Check one file of a batch. Returns whether the file passed.
+static bool checkFile(const std::string& path, bool checkTypes){
+	SourceBuffer * input = SourceBuffer::open(path.c_str());
+	if (input == nullptr){
+		Report::note("Bad path " + path + "\n");
+		return false;
+	}
+	bool passed = false;
+	try {
+		holeyc::Compilation comp(input, options);
+		if (checkTypes){
+			passed = comp.types() != nullptr;
+			if (!passed){ Report::note("Type Analysis Failed\n"); }
+		} else {
+			passed = comp.recognize();
+			if (!passed){ Report::note("Parse failed\n"); }
+		}
+	} catch (holeyc::ToDoError * e){
+		Report::note(std::string("ToDoError: ") + e->msg() + "\n");
+	} catch (holeyc::InternalError * e){
+		Report::note("InternalError: " + e->msg() + "\n");
+	} catch (holeyc::TooManyErrors * e){
+		reportTooMany(e);
+	}
+	delete input;
+	return passed;
+}
+
+//Check every file on its own Compilation, several at a time.
+// Each file's diagnostics are collected as it is checked, and
+// written out afterwards in input order (under a line naming
+// the file), so the output does not depend on the scheduling.
+static int doBatch(const std::vector<std::string>& paths,
+  bool checkTypes, size_t threads){
+	std::vector<std::string> reports(paths.size());
+	std::vector<char> passed(paths.size());
+	holeyc::WorkStealingPool pool(threads);
+	pool.run(paths.size(), [&](size_t i){
+		holeyc::DiagnosticEngine diags;
+		diags.setMaxErrors(maxErrors);
+		{
+			holeyc::DiagnosticScope scope(&diags);
+			passed[i] = checkFile(paths[i], checkTypes);
+		}
+		std::ostringstream buf;
+		diags.render(buf, buf);
+		reports[i] = buf.str();
+	});
 
-	return holeyc::TypeAnalysis::build(nameAnalysis);
+	int res = 0;
+	for (size_t i = 0; i < paths.size(); i++){
+		if (!reports[i].empty()){
+			std::cerr << paths[i] << ":\n" << reports[i];
+		}
+		if (!passed[i]){ res = 1; }
+	}
+	std::cerr << std::flush;
+	return res;
+}
+
+static bool readManifest(const char * path, 
+  std::vector<std::string>& paths){
+	std::ifstream manifest(path);
+	if (!manifest.good()){ return false; }
+	std::string line;
+	while (std::getline(manifest, line)){
+		if (!line.empty()){ paths.push_back(line); }
+	}
+	return true;
+}
+
+static int doCompilation(Compilation& comp, const char * tokensFile,
+  bool checkParse, const char * unparseFile, const char * streamFile,
+  const char * nameFile, bool checkTypes){
+	//Only build the tree if some output needs it
+	bool needAST = unparseFile != nullptr
+	  || nameFile != nullptr || checkTypes;
+	try {
+		if (tokensFile != nullptr){
+			doTokenization(comp, tokensFile);
+		}
+		if (streamFile != nullptr){
+			doStreamUnparsing(comp, streamFile, needAST);
+		}
+		if (checkParse){
+			bool ok = needAST ? comp.ast() != nullptr
+			  : comp.recognize();
+			if (!ok){
+				Report::note("Parse failed");
+			}
+		}
+		if (unparseFile != nullptr){
+			doUnparsing(comp, unparseFile);
+		}
+		if (nameFile){
+			holeyc::NameAnalysis * na;
+			na = comp.names(); 
+			if (na != nullptr){
+				outputAST(na->ast, nameFile);
+				return 0;
+			}
+			Report::note("Name Analysis Failed\n");
+			return 1;
+		}
+		if (checkTypes){
+			if (comp.types() != nullptr){
+				return 0;
+			}
+			Report::note("Type Analysis Failed\n");
+			return 1;
+		}
+	} catch (holeyc::ToDoError * e){
+		Report::note(std::string("ToDoError: ") + e->msg() + "\n");
+		return 1;
+	} catch (holeyc::InternalError * e){
+		Report::note("InternalError: " + e->msg() + "\n");
+		return 1;
+	} catch (holeyc::TooManyErrors * e){
+		reportTooMany(e);
+		return 1;
+	}
+	return 0;
 }
 
 int main(int argc, char * argv[]){
 	if (argc <= 1){ usageAndDie(); }
-	std::ifstream * input = new std::ifstream(argv[1]);
-	if (input == NULL){ usageAndDie(); }
-	if (!input->good()){
-		std::cerr << "Bad path " <<  argv[1] << std::endl;
-		usageAndDie();
-	}
+
+	std::vector<std::string> inputs;
+	bool batch = false;		// Set if given a manifest
+	size_t batchThreads = std::thread::hardware_concurrency();
 
 	const char * tokensFile = nullptr; // Output file if 
 	                                   // printing tokens
@@ -117,6 +256,8 @@ int main(int argc, char * argv[]){
 					   // syntactic analysis
 	const char * unparseFile = NULL;   // Output file if 
 	                                   // unparsing
+	const char * streamFile = nullptr; // Output file if 
+	                                   // unparsing as we parse
 	const char * nameFile = NULL;	   // Output file if doing
 					   // name analysis
 	bool useful = false; // Check whether the command is 
@@ -131,7 +272,6 @@ int main(int argc, char * argv[]){
 				tokensFile = argv[i];
 				useful = true;
 			} else if (argv[i][1] == 'p'){
-				i++;
 				checkParse = true;
 				useful = true;
 			} else if (argv[i][1] == 'u'){
@@ -139,65 +279,128 @@ int main(int argc, char * argv[]){
 				if (i >= argc){ usageAndDie(); }
 				unparseFile = argv[i];
 				useful = true;
+			} else if (argv[i][1] == 'U'){
+				i++;
+				if (i >= argc){ usageAndDie(); }
+				streamFile = argv[i];
+				useful = true;
 			} else if (argv[i][1] == 'n'){
 				i++;
 				if (i >= argc){ usageAndDie(); }
 				nameFile = argv[i];
 				useful = true;
 			} else if (argv[i][1] == 'c'){
-				i++;
 				checkTypes = true;
 				useful = true;
+			} else if (argv[i][1] == 'l'){
+				i++;
+				if (i >= argc){ usageAndDie(); }
+				if (strcmp(argv[i], "simd") == 0){
+					options.useSimdLexer = true;
+				} else if (strcmp(argv[i], "pipe") == 0){
+					options.usePipeline = true;
+				} else if (strcmp(argv[i], "flex") != 0){
+					std::cerr << "Unknown lexer " 
+					  << argv[i] << "\n";
+					usageAndDie();
+				}
+			} else if (argv[i][1] == 'j'){
+				i++;
+				if (i >= argc){ usageAndDie(); }
+				int threads = atoi(argv[i]);
+				if (threads < 1){ usageAndDie(); }
+				if (threads > 1){
+					options.lexPool = new holeyc::ThreadPool(
+						static_cast<size_t>(threads));
+				}
+			} else if (argv[i][1] == 's'){
+				i++;
+				if (i >= argc){ usageAndDie(); }
+				if (strcmp(argv[i], "chain") == 0){
+					options.useScopeChain = true;
+				} else if (strcmp(argv[i], "stack") != 0){
+					std::cerr << "Unknown symbol table " 
+					  << argv[i] << "\n";
+					usageAndDie();
+				}
+			} else if (argv[i][1] == 'C'){
+				i++;
+				if (i >= argc){ usageAndDie(); }
+				struct stat info;
+				if (stat(argv[i], &info) != 0 
+				  || !S_ISDIR(info.st_mode)){
+					std::cerr << "Bad cache directory " 
+					  << argv[i] << "\n";
+					usageAndDie();
+				}
+				options.tokenCacheDir = argv[i];
+			} else if (strncmp(argv[i], "-fmax-errors=", 13) == 0){
+				int limit = atoi(argv[i] + 13);
+				if (limit < 0){ usageAndDie(); }
+				maxErrors = static_cast<size_t>(limit);
+			} else if (argv[i][1] == 'm'){
+				i++;
+				if (i >= argc){ usageAndDie(); }
+				if (!readManifest(argv[i], inputs)){
+					std::cerr << "Bad manifest " 
+					  << argv[i] << "\n";
+					usageAndDie();
+				}
+				batch = true;
+			} else if (argv[i][1] == 'J'){
+				i++;
+				if (i >= argc){ usageAndDie(); }
+				int threads = atoi(argv[i]);
+				if (threads < 1){ usageAndDie(); }
+				batchThreads = static_cast<size_t>(threads);
 			} else {
 				std::cerr << "Unknown option"
 				  << " " << argv[i] << "\n";
 				usageAndDie();
 			}
+		} else {
+			inputs.push_back(argv[i]);
 		}
 	}
+	if (inputs.size() > 1){ batch = true; }
 
 	if (useful == false){
 		std::cerr << "You didn't specify an operation to do!\n";
 		usageAndDie();
 	}
 
-
-	try {
-		if (tokensFile != nullptr){
-			doTokenization(input, tokensFile);
-		}
-		if (checkParse){
-			if (!syntacticAnalysis(input)){
-				std::cerr << "Parse failed";
-			}
-		}
-		if (unparseFile != nullptr){
-			doUnparsing(input, unparseFile);
-		}
-		if (nameFile){
-			holeyc::NameAnalysis * na;
-			na = doNameAnalysis(input); 
-			if (na != nullptr){
-				outputAST(na->ast, nameFile);
-				return 0;
-			}
-			std::cerr << "Name Analysis Failed\n";
-			return 1;
+	if (batch){
+		if (tokensFile || unparseFile || streamFile || nameFile){
+			std::cerr << "-t, -u, -U and -n take a single input file\n";
+			usageAndDie();
 		}
-		if (checkTypes){
-			if (doTypeAnalysis(input) != nullptr){
-				return 0;
-			}
-			std::cerr << "Type Analysis Failed\n";
-			return 1;
+		if (options.lexPool != nullptr){
+			std::cerr << "-j takes a single input file\n";
+			usageAndDie();
 		}
-	} catch (holeyc::ToDoError * e){
-		std::cerr << "ToDoError: " << e->msg() << "\n";
-		return 1;
-	} catch (holeyc::InternalError * e){
-		std::cerr << "InternalError: " << e->msg() << "\n";
-		return 1;
+		return doBatch(inputs, checkTypes, batchThreads);
 	}
 
-	return 0;
+	if (inputs.empty()){ usageAndDie(); }
+	SourceBuffer * input = SourceBuffer::open(inputs[0].c_str());
+	if (input == nullptr){
+		std::cerr << "Bad path " <<  inputs[0] << std::endl;
+		usageAndDie();
+	}
+
+	//Every output below is served from the one lexing pass,
+	// parse and analysis of the file. Everything they build
+	// is freed in one go when main returns. Diagnostics are
+	// collected along the way and written out at the end.
+	holeyc::Compilation comp(input, options);
+	holeyc::DiagnosticEngine diags;
+	diags.setMaxErrors(maxErrors);
+	int res;
+	{
+		holeyc::DiagnosticScope diagScope(&diags);
+		res = doCompilation(comp, tokensFile, checkParse,
+			unparseFile, streamFile, nameFile, checkTypes);
+	}
+	diags.render(std::cout, std::cerr);
+	return res;
 }
@@ -1,246 +1,232 @@
 #include "ast.hpp"
+#include "ast_visitor.hpp"
 #include "symbol_table.hpp"
 #include "errName.hpp"
 #include "types.hpp"
 
 namespace holeyc{
 
-bool ProgramNode::nameAnalysis(SymbolTable * symTab){
-	//Enter the global scope
-	symTab->enterScope();
-	bool res = true;
-	for (auto decl : *myGlobals){
-		res = decl->nameAnalysis(symTab) && res;
-	}
-	//Leave the global scope
-	symTab->leaveScope();
-	return res;
-}
-
-bool AssignStmtNode::nameAnalysis(SymbolTable * symTab){
-	return myExp->nameAnalysis(symTab);
-}
-
-bool PostIncStmtNode::nameAnalysis(SymbolTable * symTab){
-	return myLVal->nameAnalysis(symTab);
-}
-
-bool PostDecStmtNode::nameAnalysis(SymbolTable * symTab){
-	return myLVal->nameAnalysis(symTab);
-}
-
-bool FromConsoleStmtNode::nameAnalysis(SymbolTable * symTab){
-	return myDst->nameAnalysis(symTab);
-}
-
-bool ToConsoleStmtNode::nameAnalysis(SymbolTable * symTab){
-	return mySrc->nameAnalysis(symTab);
-}
-
-bool IfStmtNode::nameAnalysis(SymbolTable * symTab){
-	bool result = true;
-	result = myCond->nameAnalysis(symTab) && result;
-	symTab->enterScope();
-	for (auto stmt : *myBody){
-		result = stmt->nameAnalysis(symTab) && result;
-	}	
-	symTab->leaveScope();
-	return result;
-}
-
-bool IfElseStmtNode::nameAnalysis(SymbolTable * symTab){
-	bool result = true;
-	result = myCond->nameAnalysis(symTab) && result;
-	symTab->enterScope();
-	for (auto stmt : *myBodyTrue){
-		result = stmt->nameAnalysis(symTab) && result;
-	}	
-	symTab->leaveScope();
-	symTab->enterScope();
-	for (auto stmt : *myBodyFalse){
-		result = stmt->nameAnalysis(symTab) && result;
-	}	
-	symTab->leaveScope();
-	return result;
-}
-
-bool WhileStmtNode::nameAnalysis(SymbolTable * symTab){
-	bool result = true;
-	result = myCond->nameAnalysis(symTab) && result;
-	symTab->enterScope();
-	for (auto stmt : *myBody){
-		result = stmt->nameAnalysis(symTab) && result;
-	}	
-	symTab->leaveScope();
-	return result;
-}
-
-bool VarDeclNode::nameAnalysis(SymbolTable * symTab){
-	DataType * dataType = getTypeNode()->getType();
-	std::string varName = ID()->getName();
-
-	bool validType = dataType->validVarType();
-	if (!validType){
-		NameErr::badVarType(line(), col()); 
+namespace{
+
+class NameAnalyzer : public ASTVisitor<NameAnalyzer, bool>{
+public:
+	NameAnalyzer(SymbolTable * symTabIn) : symTab(symTabIn){ }
+
+	bool visitProgram(ProgramNode * node){
+		//Enter the global scope
+		symTab->enterScope();
+		bool res = true;
+		for (auto decl : node->getGlobals()){
+			res = visit(decl) && res;
+		}
+		//Leave the global scope
+		symTab->leaveScope();
+		return res;
 	}
 
-	bool validName = !symTab->clash(varName);
-	if (!validName){ 
-		NameErr::multiDecl(ID()->line(), ID()->col()); 
+	bool visitAssignStmt(AssignStmtNode * node){
+		return visit(node->getExp());
 	}
 
-	if (!validType || !validName){ 
-		return false; 
-	} else {
-		symTab->insert(new VarSymbol(varName, dataType));
-		return true;
+	bool visitPostInc(PostIncStmtNode * node){
+		return visit(node->getLVal());
 	}
-}
 
-bool FnDeclNode::nameAnalysis(SymbolTable * symTab){
-	std::string fnName = this->ID()->getName();
+	bool visitPostDec(PostDecStmtNode * node){
+		return visit(node->getLVal());
+	}
 
-	bool validRet = myRetType->nameAnalysis(symTab);
+	bool visitFromConsole(FromConsoleStmtNode * node){
+		return visit(node->getDst());
+	}
 
-	// hold onto the scope of the function.
-	ScopeTable * atFnScope = symTab->getCurrentScope();
-	//Enter a new scope for "within" this function.
-	ScopeTable * inFnScope = symTab->enterScope();
+	bool visitToConsole(ToConsoleStmtNode * node){
+		return visit(node->getSrc());
+	}
 
-	/*Note that we check for a clash of the function 
-	  name in it's declared scope (e.g. a global
-	  scope for a global function)
-	*/
-	bool validName = true;
-	if (atFnScope->clash(fnName)){
-		NameErr::multiDecl(ID()->line(), ID()->col()); 
-		validName = false;
+	bool visitIf(IfStmtNode * node){
+		bool result = true;
+		result = visit(node->getCond()) && result;
+		result = scope(node->getBody()) && result;
+		return result;
 	}
 
-	bool validFormals = true;
-	std::list<const DataType *> * formalTypes = 
-		new std::list<const DataType *>();
-	for (auto formal : *(this->myFormals)){
-		validFormals = formal->nameAnalysis(symTab) && validFormals;
-		TypeNode * typeNode = formal->getTypeNode();
-		const DataType * formalType = typeNode->getType();
-		formalTypes->push_back(formalType);
+	bool visitIfElse(IfElseStmtNode * node){
+		bool result = true;
+		result = visit(node->getCond()) && result;
+		result = scope(node->getBodyTrue()) && result;
+		result = scope(node->getBodyFalse()) && result;
+		return result;
 	}
 
+	bool visitWhile(WhileStmtNode * node){
+		bool result = true;
+		result = visit(node->getCond()) && result;
+		result = scope(node->getBody()) && result;
+		return result;
+	}
 
-	const DataType * retType = this->getRetTypeNode()->getType();
-	FnType * dataType = new FnType(formalTypes, retType);
-	//Make sure the fnSymbol is in the symbol table before 
-	// analyzing the body, to allow for recursive calls
-	if (validName){
-		atFnScope->addFn(fnName, dataType);
+	bool visitVarDecl(VarDeclNode * node){
+		DataType * dataType = node->getTypeNode()->getType();
+		NameID varName = node->ID()->getNameID();
+
+		bool validType = dataType->validVarType();
+		if (!validType){
+			NameErr::badVarType(node->line(), node->col()); 
+		}
+
+		bool validName = !symTab->clash(varName);
+		if (!validName){ 
+			NameErr::multiDecl(node->ID()->line(), node->ID()->col()); 
+		}
+
+		if (!validType || !validName){ 
+			return false; 
+		} else {
+			symTab->insert(new VarSymbol(varName, dataType));
+			return true;
+		}
 	}
 
-	bool validBody = true;
-	for (auto stmt : *myBody){
-		validBody = stmt->nameAnalysis(symTab) && validBody;
+	bool visitFnDecl(FnDeclNode * node){
+		NameID fnName = node->ID()->getNameID();
+
+		bool validRet = visit(node->getRetTypeNode());
+
+		/*Note that we check for a clash of the function 
+		  name in it's declared scope (e.g. a global
+		  scope for a global function), so do it before
+		  entering the function's own scope
+		*/
+		bool validName = true;
+		if (symTab->clash(fnName)){
+			NameErr::multiDecl(node->ID()->line(), node->ID()->col()); 
+			validName = false;
+		}
+
+		Span<FormalDeclNode *> formals = node->getFormals();
+		std::vector<const DataType *> formalTypes;
+		formalTypes.reserve(formals.size());
+		for (auto formal : formals){
+			TypeNode * typeNode = formal->getTypeNode();
+			const DataType * formalType = typeNode->getType();
+			formalTypes.push_back(formalType);
+		}
+
+		const DataType * retType = node->getRetTypeNode()->getType();
+		FnType * dataType = FnType::produce(formalTypes, retType);
+		//Make sure the fnSymbol is in the symbol table before 
+		// analyzing the body, to allow for recursive calls
+		if (validName){
+			symTab->addFn(fnName, dataType);
+		}
+
+		//Enter a new scope for "within" this function.
+		symTab->enterScope();
+
+		bool validFormals = true;
+		for (auto formal : formals){
+			validFormals = visit(formal) && validFormals;
+		}
+
+		bool validBody = true;
+		for (auto stmt : node->getBody()){
+			validBody = visit(stmt) && validBody;
+		}
+
+		symTab->leaveScope();
+		return (validRet && validFormals && validName && validBody);
 	}
 
-	symTab->leaveScope();
-	return (validRet && validFormals && validName && validBody);
-}
+	bool visitRef(RefNode * node){
+		return visit(node->ID());
+	}
 
-bool RefNode::nameAnalysis(SymbolTable * symTab){
-	return myID->nameAnalysis(symTab);
-}
+	bool visitDeref(DerefNode * node){
+		return visit(node->ID());
+	}
 
-bool DerefNode::nameAnalysis(SymbolTable * symTab){
-	return myID->nameAnalysis(symTab);
-}
+	bool visitIndex(IndexNode * node){
+		bool res = true;
+		res = visit(node->getBase()) && res;
+		res = visit(node->getIndex()) && res;
+		return res;
+	}
 
-bool IndexNode::nameAnalysis(SymbolTable * symTab){
-	bool res = true;
-	res = myBase->nameAnalysis(symTab) && res;
-	res = myOffset->nameAnalysis(symTab) && res;
-	return res;
-}
+	bool visitBinaryExp(BinaryExpNode * node){
+		bool resultLHS = visit(node->getExp1());
+		bool resultRHS = visit(node->getExp2());
+		return resultLHS && resultRHS;
+	}
 
-bool BinaryExpNode::nameAnalysis(SymbolTable * symTab){
-	bool resultLHS = myExp1->nameAnalysis(symTab);
-	bool resultRHS = myExp2->nameAnalysis(symTab);
-	return resultLHS && resultRHS;
-}
+	bool visitCallExp(CallExpNode * node){
+		bool result = true;
+		result = visit(node->ID()) && result;
+		for (auto arg : node->getArgs()){
+			result = visit(arg) && result;
+		}
+		return result;
+	}
 
-bool CallExpNode::nameAnalysis(SymbolTable* symTab){
-	bool result = true;
-	result = myID->nameAnalysis(symTab) && result;
-	for (auto arg : *myArgs){
-		result = arg->nameAnalysis(symTab) && result;
+	bool visitUnaryExp(UnaryExpNode * node){
+		return visit(node->getExp());
 	}
-	return result;
-}
 
-bool NegNode::nameAnalysis(SymbolTable* symTab){
-	return myExp->nameAnalysis(symTab);
-}
+	bool visitAssignExp(AssignExpNode * node){
+		bool result = true;
+		result = visit(node->getDst()) && result;
+		result = visit(node->getSrc()) && result;
+		return result;
+	}
 
-bool NotNode::nameAnalysis(SymbolTable* symTab){
-	return myExp->nameAnalysis(symTab);
-}
+	bool visitReturn(ReturnStmtNode * node){
+		if (node->getExp() == nullptr){ // May happen in void functions
+			return true;
+		}
+		return visit(node->getExp());
+	}
 
-bool AssignExpNode::nameAnalysis(SymbolTable* symTab){
-	bool result = true;
-	result = myDst->nameAnalysis(symTab) && result;
-	result = mySrc->nameAnalysis(symTab) && result;
-	return result;
-}
+	bool visitCallStmt(CallStmtNode * node){
+		return visit(node->getCallExp());
+	}
 
-bool ReturnStmtNode::nameAnalysis(SymbolTable * symTab){
-	if (myExp == nullptr){ // May happen in void functions
+	bool visitType(TypeNode *){
 		return true;
 	}
-	return myExp->nameAnalysis(symTab);
-}
-
-bool CallStmtNode::nameAnalysis(SymbolTable* symTab){
-	return myCallExp->nameAnalysis(symTab);
-}
-
-bool TypeNode::nameAnalysis(SymbolTable * symTab){
-	return true;
-}
 
-bool IntLitNode::nameAnalysis(SymbolTable * symTab){
-	return true;
-}
-
-bool CharLitNode::nameAnalysis(SymbolTable * symTab){
-	return true;
-}
-
-bool StrLitNode::nameAnalysis(SymbolTable * symTab){
-	return true;
-}
-
-bool NullPtrNode::nameAnalysis(SymbolTable * symTab){
-	return true;
-}
+	//Literals
+	bool visitExp(ExpNode *){
+		return true;
+	}
 
-bool TrueNode::nameAnalysis(SymbolTable * symTab){
-	return true;
-}
+	bool visitID(IDNode * node){
+		NameID myName = node->getNameID();
+		SemSymbol * sym = symTab->find(myName);
+		if (sym == nullptr){
+			return NameErr::undeclID(node->line(), node->col());
+		}
+		symTab->resolve(node, sym);
+		return true;
+	}
+private:
+	//The statements of a block, in a scope of their own
+	bool scope(Span<StmtNode *> body){
+		bool result = true;
+		symTab->enterScope();
+		for (auto stmt : body){
+			result = visit(stmt) && result;
+		}	
+		symTab->leaveScope();
+		return result;
+	}
 
-bool FalseNode::nameAnalysis(SymbolTable * symTab){
-	return true;
-}
+	SymbolTable * symTab;
+};
 
-bool IDNode::nameAnalysis(SymbolTable* symTab){
-	std::string myName = this->getName();
-	SemSymbol * sym = symTab->find(myName);
-	if (sym == nullptr){
-		return NameErr::undeclID(line(), col());
-	}
-	this->attachSymbol(sym);
-	return true;
 }
 
-void IDNode::attachSymbol(SemSymbol * symbolIn){
-	this->mySymbol = symbolIn;
+bool ProgramNode::nameAnalysis(SymbolTable * symTab){
+	return NameAnalyzer(symTab).visit(this);
 }
 
 }
@@ -9,9 +9,16 @@ namespace holeyc{
 class NameAnalysis{
 public:
 	static NameAnalysis * build(ProgramNode * astIn){
+		return build(astIn, new ScopeStackTable());
+	}
+
+	//Analyze using the given (empty) symbol table, which
+	// is deleted afterwards
+	static NameAnalysis * build(ProgramNode * astIn, 
+	  SymbolTable * symTab){
 		NameAnalysis * nameAnalysis = new NameAnalysis;
-		SymbolTable * symTab = new SymbolTable();
 		bool res = astIn->nameAnalysis(symTab);
+		nameAnalysis->symbols = std::move(symTab->resolved());
 		delete symTab;
 		if (!res){ return nullptr; }
 
@@ -19,6 +26,8 @@ public:
 		return nameAnalysis;
 	}
 	ProgramNode * ast;
+	//The symbol each IDNode refers to
+	NodeMap<SemSymbol *> symbols;
 
 private:
 	NameAnalysis(){
@@ -0,0 +1,43 @@
+#ifndef HOLEYC_NODE_MAP_HPP
+#define HOLEYC_NODE_MAP_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include "ast.hpp"
+
+namespace holeyc{
+
+//A side table holding one T per AST node, indexed by the
+// node's dense ID. Reads are a bounds check and an array
+// load; nodes with no entry read as T(). Sizing the table
+// up front to the number of nodes in the compilation (see
+// Arena::nodeCount) means it never grows during an analysis.
+template <typename T>
+class NodeMap{
+public:
+	NodeMap() { }
+	NodeMap(size_t numNodes) : myValues(numNodes, T()){ }
+
+	T get(const ASTNode * node) const {
+		uint32_t id = node->nodeID();
+		if (id >= myValues.size()){ return T(); }
+		return myValues[id];
+	}
+
+	void set(const ASTNode * node, T value){
+		size_t id = node->nodeID();
+		if (id >= myValues.size()){
+			//Only nodes built after the table was sized
+			// end up here
+			myValues.resize(std::max(id + 1, myValues.size() * 2));
+		}
+		myValues[id] = value;
+	}
+private:
+	std::vector<T> myValues;
+};
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "out_buffer.hpp"
+
+namespace holeyc{
+
+//Enough tabs for any indent we produce in one copy; deeper
+// nesting just takes a few copies
+static const char TABS[] =
+	"\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+static const size_t TAB_COUNT = sizeof(TABS) - 1;
+
+//Write all of [data, data + len) to fd, retrying short and
+// interrupted writes
+static bool writeAll(int fd, const char * data, size_t len){
+	while (len > 0){
+		ssize_t wrote = ::write(fd, data, len);
+		if (wrote < 0){
+			if (errno == EINTR){ continue; }
+			return false;
+		}
+		data += wrote;
+		len -= static_cast<size_t>(wrote);
+	}
+	return true;
+}
+
+OutBuffer::OutBuffer(int fdIn) : OutBuffer(fdIn, false){ }
+
+OutBuffer::OutBuffer(int fdIn, bool ownsIn)
+: myBuf(new char[CAPACITY]), myLen(0), myFd(fdIn), ownsFd(ownsIn),
+  myFailed(false){ }
+
+OutBuffer * OutBuffer::open(const char * path){
+	int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0){ return nullptr; }
+	return new OutBuffer(fd, true);
+}
+
+OutBuffer::~OutBuffer(){
+	flush();
+	if (ownsFd){ close(myFd); }
+	delete[] myBuf;
+}
+
+bool OutBuffer::flush(){
+	if (myLen > 0 && !writeAll(myFd, myBuf, myLen)){
+		myFailed = true;
+	}
+	myLen = 0;
+	return !myFailed;
+}
+
+OutBuffer& OutBuffer::putSlow(const char * str, size_t len){
+	flush();
+	if (len >= CAPACITY){
+		//Too big to be worth copying; write it as it is
+		if (!writeAll(myFd, str, len)){ myFailed = true; }
+		return *this;
+	}
+	memcpy(myBuf, str, len);
+	myLen = len;
+	return *this;
+}
+
+void OutBuffer::putDigits(unsigned long long val){
+	char digits[20];
+	size_t start = sizeof(digits);
+	do {
+		digits[--start] = static_cast<char>('0' + val % 10);
+		val /= 10;
+	} while (val != 0);
+	put(digits + start, sizeof(digits) - start);
+}
+
+OutBuffer& OutBuffer::operator<<(int val){
+	unsigned long long mag = static_cast<unsigned long long>(val);
+	if (val < 0){
+		*this << '-';
+		//Negate in unsigned arithmetic so INT_MIN is fine
+		mag = 0ull - mag;
+	}
+	putDigits(mag);
+	return *this;
+}
+
+OutBuffer& OutBuffer::operator<<(size_t val){
+	putDigits(val);
+	return *this;
+}
+
+void OutBuffer::indent(int levels){
+	size_t count = levels > 0 ? static_cast<size_t>(levels) : 0;
+	while (count > TAB_COUNT){
+		put(TABS, TAB_COUNT);
+		count -= TAB_COUNT;
+	}
+	put(TABS, count);
+}
+
+}
@@ -0,0 +1,73 @@
+#ifndef HOLEYC_OUT_BUFFER_HPP
+#define HOLEYC_OUT_BUFFER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+namespace holeyc{
+
+//A sink for the bulk text outputs (tokens, unparsed and
+// annotated programs). Text is formatted straight into one
+// large buffer that is handed to write(2) whenever it fills,
+// so there is no per-line flushing, no virtual streambuf call
+// per fragment, and numbers are converted without consulting
+// the locale.
+class OutBuffer{
+public:
+	static const size_t CAPACITY = 1 << 16;
+
+	//Write to a descriptor that is already open (e.g.
+	// STDOUT_FILENO). The descriptor is left open.
+	explicit OutBuffer(int fdIn);
+	//Create (or truncate) the file at path. Returns nullptr
+	// if it could not be opened.
+	static OutBuffer * open(const char * path);
+	//Flushes, then closes the file if open() opened it
+	~OutBuffer();
+
+	OutBuffer(const OutBuffer&) = delete;
+	OutBuffer& operator=(const OutBuffer&) = delete;
+
+	OutBuffer& put(const char * str, size_t len){
+		if (len > CAPACITY - myLen){ return putSlow(str, len); }
+		memcpy(myBuf + myLen, str, len);
+		myLen += len;
+		return *this;
+	}
+	OutBuffer& operator<<(const char * str){
+		return put(str, strlen(str));
+	}
+	OutBuffer& operator<<(const std::string& str){
+		return put(str.data(), str.size());
+	}
+	OutBuffer& operator<<(char c){
+		if (myLen == CAPACITY){ flush(); }
+		myBuf[myLen++] = c;
+		return *this;
+	}
+	OutBuffer& operator<<(int val);
+	OutBuffer& operator<<(size_t val);
+
+	//levels tab characters
+	void indent(int levels);
+
+	//Hand everything buffered so far to the kernel. Returns
+	// false if any write since the buffer was created failed.
+	bool flush();
+	bool good() const { return !myFailed; }
+private:
+	OutBuffer(int fdIn, bool ownsIn);
+	OutBuffer& putSlow(const char * str, size_t len);
+	void putDigits(unsigned long long val);
+
+	char * myBuf;
+	size_t myLen;
+	int myFd;
+	bool ownsFd;
+	bool myFailed;
+};
+
+}
+
+#endif
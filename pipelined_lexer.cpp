@@ -0,0 +1,51 @@
+#include "pipelined_lexer.hpp"
+#include "grammar.hh"
+
+namespace holeyc{
+
+using TokenKind = holeyc::Parser::token;
+
+//Enough slack that the lexer rarely waits on the parser
+static const size_t RING_TOKENS = 4096;
+
+PipelinedLexer::PipelinedLexer(TokenStream * producer)
+: myProducer(producer), myRing(RING_TOKENS), myCancelled(false),
+  myDone(false){
+	myThread = std::thread(&PipelinedLexer::produce, this);
+}
+
+PipelinedLexer::~PipelinedLexer(){
+	//The parser may stop early on a syntax error, leaving
+	// the producer blocked on a full ring
+	myCancelled.store(true, std::memory_order_relaxed);
+	myThread.join();
+	delete myProducer;
+}
+
+void PipelinedLexer::produce(){
+	RawToken tok;
+	do {
+		myProducer->next(tok);
+		for (unsigned spins = 0; !myRing.tryPush(tok); spins++){
+			if (myCancelled.load(std::memory_order_relaxed)){
+				return;
+			}
+			if (spins > 64){ std::this_thread::yield(); }
+		}
+	} while (tok.kind != TokenKind::END);
+}
+
+void PipelinedLexer::next(RawToken& tok){
+	//Once END has come through, keep returning it
+	if (myDone){
+		tok = myEnd;
+		return;
+	}
+	myRing.pop(tok);
+	if (tok.kind == TokenKind::END){
+		myDone = true;
+		myEnd = tok;
+	}
+}
+
+}
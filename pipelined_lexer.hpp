@@ -0,0 +1,36 @@
+#ifndef HOLEYC_PIPELINED_LEXER_HPP
+#define HOLEYC_PIPELINED_LEXER_HPP
+
+#include <atomic>
+#include <thread>
+
+#include "spsc_ring.hpp"
+#include "token_stream.hpp"
+
+namespace holeyc{
+
+//Runs another token stream on its own thread, handing its
+// tokens to the consumer (normally the parser, through the
+// Scanner) over a lock-free ring. Lexing then overlaps with
+// parsing and AST construction instead of alternating with
+// it on one core.
+class PipelinedLexer : public TokenStream{
+public:
+	//Takes ownership of producer
+	PipelinedLexer(TokenStream * producer);
+	~PipelinedLexer();
+	void next(RawToken& tok) override;
+private:
+	void produce();
+
+	TokenStream * myProducer;
+	SpscRing<RawToken> myRing;
+	std::atomic<bool> myCancelled;
+	bool myDone;
+	RawToken myEnd;
+	std::thread myThread;
+};
+
+}
+
+#endif
@@ -6,20 +6,151 @@ using namespace holeyc;
 using TokenKind = holeyc::Parser::token;
 using Lexeme = holeyc::Parser::semantic_type;
 
-void Scanner::outputTokens(std::ostream& outstream){
+int Scanner::yylex(Lexeme * const lval){
+	if (myStream == nullptr){
+		return flexLex(lval);
+	}
+	return streamLex(lval);
+}
+
+//Turn the next RawToken from the stream into a semantic
+// value, reporting any lexical errors along the way exactly
+// as the matching flex rule would.
+int Scanner::streamLex(Lexeme * const lval){
+	this->yylval = lval;
+	RawToken tok;
+	while (true){
+		myStream->next(tok);
+		size_t at = tok.offset;
+		switch (tok.kind){
+		case LEXERR_ILLEGAL:
+			errIllegal(at, std::string(tok.text, tok.len));
+			continue;
+		case LEXERR_CHR_ESC_EMPTY: errChrEscEmpty(at); continue;
+		case LEXERR_CHR_EMPTY: errChrEmpty(at); continue;
+		case LEXERR_CHR_ESC: errChrEsc(at); continue;
+		case LEXERR_STR_ESC: errStrEsc(at); continue;
+		case LEXERR_STR_UNTERM:
+			errStrUnterm(at);
+			endUnterminated(at + tok.len);
+			continue;
+		case LEXERR_STR_ESC_UNTERM:
+			errStrEscAndUnterm(at);
+			endUnterminated(at + tok.len);
+			continue;
+		case LEXERR_INT_OVERFLOW:
+			//Reported, but the clamped literal still
+			// goes to the parser
+			errIntOverflow(at);
+			yylval->emplace<IntLitToken>(at, tok.intVal);
+			return TokenKind::INTLITERAL;
+		case TokenKind::END:
+			myEndOffset = at;
+			return TokenKind::END;
+		case TokenKind::ID:
+			yylval->emplace<IDToken>(at, tok.name);
+			return TokenKind::ID;
+		case TokenKind::INTLITERAL:
+			yylval->emplace<IntLitToken>(at, tok.intVal);
+			return TokenKind::INTLITERAL;
+		case TokenKind::STRLITERAL:
+			yylval->emplace<StrToken>(at, tok.text, tok.len);
+			return TokenKind::STRLITERAL;
+		case TokenKind::CHARLIT:
+			yylval->emplace<CharLitToken>(at, tok.charVal);
+			return TokenKind::CHARLIT;
+		default:
+			yylval->emplace<Token>(at, tok.kind);
+			return tok.kind;
+		}
+	}
+}
+
+void Scanner::dropLexeme(int tokenKind, Lexeme * lval){
+	switch (tokenKind){
+	case TokenKind::END: return;
+	case TokenKind::ID: lval->destroy<IDToken>(); return;
+	case TokenKind::INTLITERAL: lval->destroy<IntLitToken>(); return;
+	case TokenKind::STRLITERAL: lval->destroy<StrToken>(); return;
+	case TokenKind::CHARLIT: lval->destroy<CharLitToken>(); return;
+	default: lval->destroy<Token>(); return;
+	}
+}
+
+void Scanner::outputTokens(OutBuffer& out){
 	Lexeme lexeme;
 	int tokenKind;
 	while(true){
 		tokenKind = this->yylex(&lexeme);
 		if (tokenKind == TokenKind::END){
-			outstream << "EOF" 
-			  << " [" << this->lineNum 
-			  << "," << this->colNum << "]"
-			  << std::endl;
+			const SourceManager * sm = SourceManager::current();
+			out << "EOF [" << sm->line(myEndOffset) 
+			  << ',' << sm->col(myEndOffset) << "]\n";
 			return;
-		} else {
-			outstream << lexeme.transToken->toString()
-			  << std::endl;
 		}
+		switch (tokenKind){
+		case TokenKind::ID:
+			lexeme.as<IDToken>().print(out);
+			break;
+		case TokenKind::INTLITERAL:
+			lexeme.as<IntLitToken>().print(out);
+			break;
+		case TokenKind::STRLITERAL:
+			lexeme.as<StrToken>().print(out);
+			break;
+		case TokenKind::CHARLIT:
+			lexeme.as<CharLitToken>().print(out);
+			break;
+		default:
+			lexeme.as<Token>().print(out);
+		}
+		out << '\n';
+		dropLexeme(tokenKind, &lexeme);
+	}
+}
+
+void Scanner::recordTokens(std::vector<RawToken>& out){
+	Lexeme lexeme;
+	while(true){
+		RawToken tok = RawToken();
+		tok.kind = this->yylex(&lexeme);
+		if (tok.kind == TokenKind::END){
+			tok.offset = static_cast<uint32_t>(myEndOffset);
+			out.push_back(tok);
+			return;
+		}
+		const Token * base;
+		switch (tok.kind){
+		case TokenKind::ID: {
+			const IDToken& id = lexeme.as<IDToken>();
+			tok.name = id.name();
+			base = &id;
+			break;
+		}
+		case TokenKind::INTLITERAL: {
+			const IntLitToken& lit = lexeme.as<IntLitToken>();
+			tok.intVal = lit.num();
+			base = &lit;
+			break;
+		}
+		case TokenKind::STRLITERAL: {
+			const StrToken& lit = lexeme.as<StrToken>();
+			tok.text = lit.text();
+			tok.len = lit.length();
+			base = &lit;
+			break;
+		}
+		case TokenKind::CHARLIT: {
+			const CharLitToken& lit = lexeme.as<CharLitToken>();
+			tok.charVal = lit.val();
+			base = &lit;
+			break;
+		}
+		default:
+			base = &lexeme.as<Token>();
+		}
+		tok.offset = static_cast<uint32_t>(base->offset());
+		out.push_back(tok);
+		dropLexeme(tok.kind, &lexeme);
 	}
 }
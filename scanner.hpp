@@ -6,7 +6,12 @@
 #endif
 
 #include "grammar.hh"
+#include "arena.hpp"
 #include "errors.hpp"
+#include "out_buffer.hpp"
+#include "source_buffer.hpp"
+#include "source_manager.hpp"
+#include "token_stream.hpp"
 
 using TokenKind = holeyc::Parser::token;
 
@@ -15,113 +20,157 @@ namespace holeyc{
 class Scanner : public yyFlexLexer{
 public:
    
-   Scanner(std::istream *in) : yyFlexLexer(in)
+   //Scan a mapped source file in place. Tokens are made
+   // with offsets into it; the line and column of each come
+   // from the SourceManager installed while the scanner
+   // runs, which must be the one for src.
+   Scanner(SourceBuffer * src) : yyFlexLexer(nullptr)
    {
-	lineNum = 1;
-	colNum = 1;
 	hasError = false;
+	mySource = src;
+	myStream = nullptr;
+	myEndOffset = src->size();
+	scanSource(src);
+   };
+
+   //Take tokens from some other lexer (which the scanner
+   // then owns) instead of the flex rules in holeyc.l. The
+   // parser and outputTokens see no difference.
+   Scanner(TokenStream * tokens) : yyFlexLexer(nullptr)
+   {
+	hasError = false;
+	mySource = nullptr;
+	myStream = tokens;
+	myEndOffset = 0;
    };
    virtual ~Scanner() {
+	//Flex NUL-terminates the current match in place;
+	// put the saved character back so the shared
+	// buffer is intact for the next scanner over it
+	if (mySource != nullptr && yy_c_buf_p != nullptr){
+		*yy_c_buf_p = yy_hold_char;
+	}
+	delete myStream;
    };
 
    //get rid of override virtual function warning
    using FlexLexer::yylex;
 
-   // YY_DECL defined in the flex holeyc.l
    virtual int yylex( holeyc::Parser::semantic_type * const lval);
 
+   // YY_DECL defined in the flex holeyc.l
+   int flexLex( holeyc::Parser::semantic_type * const lval);
+
+   //Where the current match starts in the source. Flex scans
+   // the source in place, so this needs no bookkeeping.
+   size_t matchOffset() const {
+	return static_cast<size_t>(yytext - mySource->data());
+   }
+
    int makeBareToken(int tagIn){
-        this->yylval->transToken = new Token(
-	  this->lineNum, this->colNum, tagIn);
-        colNum += static_cast<size_t>(yyleng);
+        this->yylval->emplace<Token>(matchOffset(), tagIn);
         return tagIn;
    }
 
-   int makeCharLitToken(const std::string text){
-	char val;
-	if (text.length() == 2){
-		val = text.c_str()[1];
-	} else if (text == "'\\t"){
-		val = '\t';
-	} else if (text == "'\\n"){
-		val = '\n';
-	} else if (text == "'\\\\"){
-		val = '\\';
-	} else {
-		val = text.c_str()[1];
-	}
-	this->yylval->transToken = new CharLitToken(
-		this->lineNum, this->colNum, val);
-	colNum += static_cast<size_t>(yyleng);
+   //val is already decoded by the rule that matched
+   int makeCharLitToken(char val){
+	this->yylval->emplace<CharLitToken>(matchOffset(), val);
 	return TokenKind::CHARLIT;
    }
 
-   void errIllegal(size_t l, size_t c, std::string match){
-	Report::fatal(l, c, "Illegal character "
-		+ match);
-	hasError = true;
+   //A comment is the one match that didn't move the flex
+   // scanner's column, so one that runs to the end of the
+   // input is where the input ends
+   void endComment(){
+	if (yytext + yyleng == mySource->end()){
+		myEndOffset = matchOffset();
+	}
    }
 
-   void errChrEscEmpty(size_t l, size_t c){
-	Report::fatal(l, c, "Empty escape sequence in"
-	" character literal");
-	hasError = true;
+   //Columns after an unterminated string literal have always
+   // been counted from where it ends
+   void endUnterminated(size_t end){
+	SourceManager::current()->restartColumn(end);
    }
 
-   void errChrEmpty(size_t l, size_t c){
-	Report::fatal(l, c, "Empty character literal");
-	hasError = true;
+   void errIllegal(size_t offset, std::string match){
+	lexError(offset, "Illegal character " + match);
    }
 
-   void errChrEsc(size_t l, size_t c){
-	Report::fatal(l, c, "Bad escape sequence in"
-	" char literal");
-	hasError = true;
+   void errChrEscEmpty(size_t offset){
+	lexError(offset, "Empty escape sequence in character literal");
    }
 
-   void errStrEsc(size_t l, size_t c){
-	Report::fatal(l, c, "String literal with bad"
-	" escape sequence ignored");
-	hasError = true;
+   void errChrEmpty(size_t offset){
+	lexError(offset, "Empty character literal");
    }
 
-   void errStrUnterm(size_t l, size_t c){
-	Report::fatal(l, c, "Unterminated string"
-	" literal ignored");
-	hasError = true;
-	
+   void errChrEsc(size_t offset){
+	lexError(offset, "Bad escape sequence in char literal");
+   }
+
+   void errStrEsc(size_t offset){
+	lexError(offset, "String literal with bad escape sequence ignored");
+   }
+
+   void errStrUnterm(size_t offset){
+	lexError(offset, "Unterminated string literal ignored");
    }
 
-   void errStrEscAndUnterm(size_t l, size_t c){
-	Report::fatal(l, c, "Unterminated string literal"
+   void errStrEscAndUnterm(size_t offset){
+	lexError(offset, "Unterminated string literal"
 	"  with bad escape sequence ignored");
-	hasError = true;
    }
 
-   void errIntOverflow(size_t l, size_t c){
-	Report::fatal(l, c, "Integer literal too large;"
-	"  using max value");
-	hasError = true;
+   void errIntOverflow(size_t offset){
+	lexError(offset, "Integer literal too large;  using max value");
    }
 
    void warn(int lineNumIn, int colNumIn, std::string msg){
-	std::cerr << lineNumIn << ":" << colNumIn 
-		<< " ***WARNING*** " << msg << std::endl;
+	Report::note(std::to_string(lineNumIn) + ":" 
+		+ std::to_string(colNumIn) + " ***WARNING*** " + msg + "\n");
    }
 
    void error(int lineNumIn, int colNumIn, std::string msg){
-	std::cerr << lineNumIn << ":" << colNumIn 
-		<< " ***ERROR*** " << msg << std::endl;
+	Report::note(std::to_string(lineNumIn) + ":" 
+		+ std::to_string(colNumIn) + " ***ERROR*** " + msg + "\n");
    }
 
    static std::string tokenKindString(int tokenKind);
 
-   void outputTokens(std::ostream& outstream);
+   //Destroy the token a yylex call left in lval, for
+   // callers that pull tokens without handing them to the
+   // parser (which otherwise owns them)
+   static void dropLexeme(int tokenKind, 
+     holeyc::Parser::semantic_type * lval);
+
+   void outputTokens(OutBuffer& out);
+
+   //Lex the whole input, appending every token (and the
+   // final END) to out. Lexical errors are reported as
+   // they are found, so a TokenReplay of the recording
+   // carries the tokens only. String payloads stay views
+   // of the text the tokens were scanned from.
+   void recordTokens(std::vector<RawToken>& out);
 
 private:
+   // Defined in holeyc.l, where flex's buffer internals
+   // are visible
+   void scanSource(SourceBuffer * src);
+   int streamLex( holeyc::Parser::semantic_type * const lval);
+
+   void lexError(size_t offset, const std::string& msg){
+	const SourceManager * sm = SourceManager::current();
+	Report::fatal(DiagCode::LEXICAL, sm->line(offset), sm->col(offset),
+		msg);
+	hasError = true;
+   }
+
    holeyc::Parser::semantic_type *yylval = nullptr;
-   size_t lineNum;
-   size_t colNum;
+   SourceBuffer * mySource;
+   TokenStream * myStream;
+   //Where END is reported
+   size_t myEndOffset;
    bool hasError;
 };
 
@@ -0,0 +1,492 @@
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "simd_lexer.hpp"
+#include "literals.hpp"
+#include "grammar.hh"
+
+namespace holeyc{
+
+using TokenKind = holeyc::Parser::token;
+
+//Byte classes used to pick a rule from the first character
+// of a token.
+enum CharClass{
+	CC_OTHER, CC_BLANK, CC_NL, CC_CR, CC_HASH,
+	CC_WORD, CC_DIGIT, CC_DQUOTE, CC_SQUOTE, CC_PUNCT
+};
+
+static unsigned char charClasses[256];
+
+static bool buildCharClasses(){
+	for (int c = 0; c < 256; c++){
+		unsigned char cls = CC_OTHER;
+		if (c == ' ' || c == '\t'){ cls = CC_BLANK; }
+		else if (c == '\n'){ cls = CC_NL; }
+		else if (c == '\r'){ cls = CC_CR; }
+		else if (c == '#'){ cls = CC_HASH; }
+		else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+		  || c == '_'){ cls = CC_WORD; }
+		else if (c >= '0' && c <= '9'){ cls = CC_DIGIT; }
+		else if (c == '"'){ cls = CC_DQUOTE; }
+		else if (c == '\''){ cls = CC_SQUOTE; }
+		else if (strchr("@^[]{}();,+-*/!&|=<>", c) != nullptr){
+			cls = CC_PUNCT;
+		}
+		charClasses[c] = cls;
+	}
+	return true;
+}
+
+static const bool charClassesBuilt = buildCharClasses();
+
+static inline unsigned char classOf(char c){
+	return charClasses[static_cast<unsigned char>(c)];
+}
+
+//Vector helpers. Each byte class below provides a vector test
+// (a byte mask, 0xFF where the byte is in the class) and the
+// equivalent scalar test for the tail.
+#if defined(__AVX2__)
+typedef __m256i Vec;
+static const size_t VEC_BYTES = 32;
+static inline Vec load(const char * p){
+	return _mm256_loadu_si256(reinterpret_cast<const Vec *>(p));
+}
+static inline Vec splat(int c){
+	return _mm256_set1_epi8(static_cast<char>(c));
+}
+static inline Vec eq(Vec a, Vec b){ return _mm256_cmpeq_epi8(a, b); }
+static inline Vec lt(Vec a, Vec b){ return _mm256_cmpgt_epi8(b, a); }
+static inline Vec add(Vec a, Vec b){ return _mm256_add_epi8(a, b); }
+static inline Vec vor(Vec a, Vec b){ return _mm256_or_si256(a, b); }
+static inline unsigned misses(Vec m){
+	return ~static_cast<unsigned>(_mm256_movemask_epi8(m));
+}
+#elif defined(__SSE2__)
+typedef __m128i Vec;
+static const size_t VEC_BYTES = 16;
+static inline Vec load(const char * p){
+	return _mm_loadu_si128(reinterpret_cast<const Vec *>(p));
+}
+static inline Vec splat(int c){
+	return _mm_set1_epi8(static_cast<char>(c));
+}
+static inline Vec eq(Vec a, Vec b){ return _mm_cmpeq_epi8(a, b); }
+static inline Vec lt(Vec a, Vec b){ return _mm_cmplt_epi8(a, b); }
+static inline Vec add(Vec a, Vec b){ return _mm_add_epi8(a, b); }
+static inline Vec vor(Vec a, Vec b){ return _mm_or_si128(a, b); }
+static inline unsigned misses(Vec m){
+	return ~static_cast<unsigned>(_mm_movemask_epi8(m)) & 0xFFFFu;
+}
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+//0xFF in each byte of v that lies in [lo, hi]. There is no
+// unsigned byte compare, so bias the range down to start at
+// -128 and do a single signed compare.
+static inline Vec inRange(Vec v, int lo, int hi){
+	Vec shifted = add(v, splat(0x80 - lo));
+	return lt(shifted, splat(-0x80 + (hi - lo + 1)));
+}
+#endif
+
+struct BlankClass{
+#if defined(__AVX2__) || defined(__SSE2__)
+	static Vec test(Vec v){ return vor(eq(v, splat(' ')), eq(v, splat('\t'))); }
+#endif
+	static bool test(char c){ return c == ' ' || c == '\t'; }
+};
+
+struct DigitClass{
+#if defined(__AVX2__) || defined(__SSE2__)
+	static Vec test(Vec v){ return inRange(v, '0', '9'); }
+#endif
+	static bool test(char c){ return c >= '0' && c <= '9'; }
+};
+
+struct WordClass{
+#if defined(__AVX2__) || defined(__SSE2__)
+	static Vec test(Vec v){
+		Vec lower = vor(v, splat(0x20));
+		return vor(vor(inRange(lower, 'a', 'z'), inRange(v, '0', '9')),
+			eq(v, splat('_')));
+	}
+#endif
+	static bool test(char c){
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+		  || (c >= '0' && c <= '9') || c == '_';
+	}
+};
+
+//Everything that can't end a comment
+struct NotNewlineClass{
+#if defined(__AVX2__) || defined(__SSE2__)
+	static Vec test(Vec v){
+		//Compare-equal gives the newlines; flip it
+		return eq(eq(v, splat('\n')), splat(0));
+	}
+#endif
+	static bool test(char c){ return c != '\n'; }
+};
+
+//Plain string body characters: anything but a quote, an
+// escape or the end of the line
+struct StrBodyClass{
+#if defined(__AVX2__) || defined(__SSE2__)
+	static Vec test(Vec v){
+		Vec stop = vor(vor(eq(v, splat('"')), eq(v, splat('\\'))),
+			eq(v, splat('\n')));
+		return eq(stop, splat(0));
+	}
+#endif
+	static bool test(char c){ return c != '"' && c != '\\' && c != '\n'; }
+};
+
+//Return the first position in [p, end) whose byte is not in
+// Class, or end if there is none.
+template <typename Class>
+static inline const char * skip(const char * p, const char * end){
+#if defined(__AVX2__) || defined(__SSE2__)
+	while (p < end){
+		unsigned stops = misses(Class::test(load(p)));
+		if (stops != 0){
+			p += __builtin_ctz(stops);
+			return p < end ? p : end;
+		}
+		p += VEC_BYTES;
+	}
+	return end;
+#else
+	while (p < end && Class::test(*p)){ p++; }
+	return p;
+#endif
+}
+
+//Keyword recognition. The hash below is collision-free over
+// the 16 HoleyC keywords (found by a small offline search),
+// so a word is a keyword iff the one slot it hashes to
+// holds exactly that word.
+struct KeywordSlot{
+	const char * word;
+	size_t len;
+	int kind;
+};
+
+static const KeywordSlot keywords[32] = {
+	/* 0*/ {nullptr, 0, 0},
+	/* 1*/ {"NULLPTR", 7, TokenKind::NULLPTR},
+	/* 2*/ {nullptr, 0, 0},
+	/* 3*/ {nullptr, 0, 0},
+	/* 4*/ {"int", 3, TokenKind::INT},
+	/* 5*/ {nullptr, 0, 0},
+	/* 6*/ {"true", 4, TokenKind::TRUE},
+	/* 7*/ {nullptr, 0, 0},
+	/* 8*/ {nullptr, 0, 0},
+	/* 9*/ {nullptr, 0, 0},
+	/*10*/ {"while", 5, TokenKind::WHILE},
+	/*11*/ {"TOCONSOLE", 9, TokenKind::TOCONSOLE},
+	/*12*/ {"return", 6, TokenKind::RETURN},
+	/*13*/ {nullptr, 0, 0},
+	/*14*/ {"bool", 4, TokenKind::BOOL},
+	/*15*/ {"if", 2, TokenKind::IF},
+	/*16*/ {nullptr, 0, 0},
+	/*17*/ {nullptr, 0, 0},
+	/*18*/ {"void", 4, TokenKind::VOID},
+	/*19*/ {"char", 4, TokenKind::CHAR},
+	/*20*/ {nullptr, 0, 0},
+	/*21*/ {"boolptr", 7, TokenKind::BOOLPTR},
+	/*22*/ {"charptr", 7, TokenKind::CHARPTR},
+	/*23*/ {"else", 4, TokenKind::ELSE},
+	/*24*/ {nullptr, 0, 0},
+	/*25*/ {"false", 5, TokenKind::FALSE},
+	/*26*/ {nullptr, 0, 0},
+	/*27*/ {"intptr", 6, TokenKind::INTPTR},
+	/*28*/ {nullptr, 0, 0},
+	/*29*/ {nullptr, 0, 0},
+	/*30*/ {nullptr, 0, 0},
+	/*31*/ {"FROMCONSOLE", 11, TokenKind::FROMCONSOLE},
+};
+
+static inline int keywordKind(const char * word, size_t len){
+	size_t first = static_cast<unsigned char>(word[0]);
+	size_t last = static_cast<unsigned char>(word[len - 1]);
+	const KeywordSlot& slot = keywords[(len + first + 22 * last) & 31];
+	if (slot.len == len && memcmp(slot.word, word, len) == 0){
+		return slot.kind;
+	}
+	return TokenKind::ID;
+}
+
+static inline bool isEscapee(char c){
+	return STRING_ESCAPES[c] != 0;
+}
+
+void SimdLexer::emit(RawToken& tok, int kind, size_t len){
+	tok.kind = kind;
+	tok.offset = static_cast<uint32_t>(myPos - myBase);
+	tok.text = myPos;
+	tok.len = len;
+	tok.intVal = 0;
+	tok.charVal = 0;
+	tok.name = 0;
+}
+
+void SimdLexer::next(RawToken& tok){
+	while (myPos < myEnd){
+		const char * p = myPos;
+		switch (classOf(*p)){
+		case CC_BLANK:
+			myPos = skip<BlankClass>(p, myEnd);
+			continue;
+		case CC_NL:
+			myPos = p + 1;
+			continue;
+		case CC_CR:
+			if (p + 1 < myEnd && p[1] == '\n'){
+				myPos = p + 2;
+				continue;
+			}
+			break;
+		case CC_HASH:
+			myPos = skip<NotNewlineClass>(p, myEnd);
+			if (myPos == myEnd){
+				//Comments never moved the flex scanner's
+				// column, so one that runs to the end of the
+				// input ends it where it starts
+				myPos = myEnd = p;
+			}
+			continue;
+		case CC_WORD:
+			lexWord(tok);
+			return;
+		case CC_DIGIT:
+			lexNumber(tok);
+			return;
+		case CC_DQUOTE:
+			lexString(tok);
+			return;
+		case CC_SQUOTE:
+			lexChar(tok);
+			return;
+		case CC_PUNCT: {
+			char c = *p;
+			char n = (p + 1 < myEnd) ? p[1] : '\0';
+			int kind = 0;
+			size_t len = 1;
+			switch (c){
+			case '@': kind = TokenKind::AT; break;
+			case '^': kind = TokenKind::CARAT; break;
+			case '[': kind = TokenKind::LBRACE; break;
+			case ']': kind = TokenKind::RBRACE; break;
+			case '{': kind = TokenKind::LCURLY; break;
+			case '}': kind = TokenKind::RCURLY; break;
+			case '(': kind = TokenKind::LPAREN; break;
+			case ')': kind = TokenKind::RPAREN; break;
+			case ';': kind = TokenKind::SEMICOLON; break;
+			case ',': kind = TokenKind::COMMA; break;
+			case '*': kind = TokenKind::STAR; break;
+			case '/': kind = TokenKind::SLASH; break;
+			case '+':
+				if (n == '+'){ kind = TokenKind::CROSSCROSS; len = 2; }
+				else { kind = TokenKind::CROSS; }
+				break;
+			case '-':
+				if (n == '-'){ kind = TokenKind::DASHDASH; len = 2; }
+				else { kind = TokenKind::DASH; }
+				break;
+			case '!':
+				if (n == '='){ kind = TokenKind::NOTEQUALS; len = 2; }
+				else { kind = TokenKind::NOT; }
+				break;
+			case '=':
+				if (n == '='){ kind = TokenKind::EQUALS; len = 2; }
+				else { kind = TokenKind::ASSIGN; }
+				break;
+			case '<':
+				if (n == '='){ kind = TokenKind::LESSEQ; len = 2; }
+				else { kind = TokenKind::LESS; }
+				break;
+			case '>':
+				if (n == '='){ kind = TokenKind::GREATEREQ; len = 2; }
+				else { kind = TokenKind::GREATER; }
+				break;
+			case '&':
+				if (n == '&'){ kind = TokenKind::AND; len = 2; }
+				break;
+			case '|':
+				if (n == '|'){ kind = TokenKind::OR; len = 2; }
+				break;
+			}
+			if (kind == 0){ break; } //Lone & or |
+			emit(tok, kind, len);
+			myPos = p + len;
+			return;
+		}
+		default:
+			break;
+		}
+
+		//Nothing matched: a single illegal character
+		emit(tok, LEXERR_ILLEGAL, 1);
+		myPos = p + 1;
+		return;
+	}
+
+	emit(tok, TokenKind::END, 0);
+}
+
+void SimdLexer::lexWord(RawToken& tok){
+	const char * q = skip<WordClass>(myPos + 1, myEnd);
+	size_t len = static_cast<size_t>(q - myPos);
+	int kind = keywordKind(myPos, len);
+	emit(tok, kind, len);
+	if (kind == TokenKind::ID){
+		tok.name = InternTable::global()->intern(myPos, len);
+	}
+	myPos = q;
+}
+
+void SimdLexer::lexNumber(RawToken& tok){
+	const char * q = skip<DigitClass>(myPos + 1, myEnd);
+	size_t len = static_cast<size_t>(q - myPos);
+
+	int value;
+	if (decodeInt(myPos, len, &value)){
+		emit(tok, TokenKind::INTLITERAL, len);
+	} else {
+		//The caller reports the overflow and then still
+		// produces the (clamped) literal
+		emit(tok, LEXERR_INT_OVERFLOW, len);
+	}
+	tok.intVal = value;
+	myPos = q;
+}
+
+void SimdLexer::lexChar(RawToken& tok){
+	const char * p = myPos;
+	bool has1 = p + 1 < myEnd;
+	char c1 = has1 ? p[1] : '\0';
+
+	if (!has1){
+		//A lone quote at the end of input
+		emit(tok, LEXERR_ILLEGAL, 1);
+		myPos = p + 1;
+		return;
+	}
+	if (c1 == '\n'){
+		emit(tok, LEXERR_CHR_EMPTY, 2);
+		myPos = p + 2;
+		return;
+	}
+	if (c1 != '\\'){
+		emit(tok, TokenKind::CHARLIT, 2);
+		tok.charVal = c1;
+		myPos = p + 2;
+		return;
+	}
+
+	bool has2 = p + 2 < myEnd;
+	char c2 = has2 ? p[2] : '\0';
+	if (!has2 || c2 == '\n'){
+		emit(tok, LEXERR_CHR_ESC_EMPTY, 2);
+		myPos = p + 2;
+		return;
+	}
+
+	char val = CHAR_ESCAPES[c2];
+	if (val == 0){
+		emit(tok, LEXERR_CHR_ESC, 3);
+		myPos = p + 3;
+		return;
+	}
+	emit(tok, TokenKind::CHARLIT, 3);
+	tok.charVal = val;
+	myPos = p + 3;
+}
+
+//Strings are the one place where flex's longest-match rule
+// has to be reproduced carefully, since four rules in
+// holeyc.l overlap:
+//   S1 "(N|E)*"               a good string
+//   S2 "(N|E)*                unterminated
+//   S3 "(N|E)*\B[^\n"]*"      bad escape
+//   S4 "(N|E)*(\B)?(N|E)*\?   bad escape and/or unterminated
+// where N is a plain character and E a valid escape. Ties go
+// to the earlier rule.
+void SimdLexer::lexString(RawToken& tok){
+	const char * p = myPos;
+	const char * lineEnd = skip<NotNewlineClass>(p + 1, myEnd);
+
+	//Walk the longest run of good characters and escapes
+	const char * i = p + 1;
+	while (true){
+		i = skip<StrBodyClass>(i, lineEnd);
+		if (i >= lineEnd || *i == '"'){ break; }
+		//A backslash: keep going only if it is a valid escape
+		if (i + 1 < lineEnd && isEscapee(i[1])){
+			i += 2;
+			continue;
+		}
+		break;
+	}
+
+	if (i < lineEnd && *i == '"'){
+		size_t len = static_cast<size_t>(i + 1 - p);
+		emit(tok, TokenKind::STRLITERAL, len);
+		myPos = i + 1;
+		return;
+	}
+
+	if (i >= lineEnd){
+		emit(tok, LEXERR_STR_UNTERM, static_cast<size_t>(i - p));
+		myPos = i;
+		return;
+	}
+
+	//i is a backslash that doesn't start a valid escape
+	if (i + 1 >= lineEnd){
+		size_t len = static_cast<size_t>(i + 1 - p);
+		emit(tok, LEXERR_STR_ESC_UNTERM, len);
+		myPos = i + 1;
+		return;
+	}
+
+	//S4: good characters after the bad escape, plus an
+	// optional trailing backslash
+	const char * r = i + 2;
+	while (true){
+		r = skip<StrBodyClass>(r, lineEnd);
+		if (r >= lineEnd || *r == '"'){ break; }
+		if (r + 1 < lineEnd && isEscapee(r[1])){
+			r += 2;
+			continue;
+		}
+		r += 1;
+		break;
+	}
+	size_t unterminatedLen = static_cast<size_t>(r - p);
+
+	//S3: anything up to the next quote on the line, escaped
+	// or not
+	const char * q = static_cast<const char *>(
+		memchr(i + 2, '"', static_cast<size_t>(lineEnd - (i + 2))));
+	if (q != nullptr){
+		size_t badEscLen = static_cast<size_t>(q + 1 - p);
+		if (badEscLen >= unterminatedLen){
+			emit(tok, LEXERR_STR_ESC, badEscLen);
+			myPos = q + 1;
+			return;
+		}
+	}
+
+	emit(tok, LEXERR_STR_ESC_UNTERM, unterminatedLen);
+	myPos = r;
+}
+
+}
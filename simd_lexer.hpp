@@ -0,0 +1,47 @@
+#ifndef HOLEYC_SIMD_LEXER_HPP
+#define HOLEYC_SIMD_LEXER_HPP
+
+#include "source_buffer.hpp"
+#include "token_stream.hpp"
+
+namespace holeyc{
+
+//A hand-written replacement for the flex scanner in holeyc.l.
+// It produces exactly the same tokens, positions and lexical
+// errors, but skips whitespace and comments and classifies
+// identifier and digit runs a vector at a time (SSE2, or AVX2
+// when built with -mavx2) rather than one DFA transition per
+// byte. Keywords are recognized with a perfect hash.
+//
+//The lexer reads up to 32 bytes past the current position,
+// so the range it is given must be followed by at least that
+// many readable bytes (SourceBuffer's padding guarantees
+// this for the end of the file).
+class SimdLexer : public TokenStream{
+public:
+	SimdLexer(const SourceBuffer * src)
+	: myBase(src->data()), myPos(src->data()), myEnd(src->end()){ }
+
+	//Lex only [begin, end) of src, which must start at the
+	// beginning of a line. Offsets are still from the start
+	// of src.
+	SimdLexer(const SourceBuffer * src, const char * begin,
+	  const char * end)
+	: myBase(src->data()), myPos(begin), myEnd(end){ }
+
+	void next(RawToken& tok) override;
+private:
+	void emit(RawToken& tok, int kind, size_t len);
+	void lexString(RawToken& tok);
+	void lexChar(RawToken& tok);
+	void lexNumber(RawToken& tok);
+	void lexWord(RawToken& tok);
+
+	const char * myBase;
+	const char * myPos;
+	const char * myEnd;
+};
+
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include <fcntl.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "source_buffer.hpp"
+
+namespace holeyc{
+
+static size_t roundToPage(size_t len){
+	size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	return (len + page - 1) / page * page;
+}
+
+//Reserve a zero-filled, private region large enough to hold
+// len bytes plus the trailing padding.
+static char * reserve(size_t mapLen){
+	void * region = mmap(nullptr, mapLen, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (region == MAP_FAILED){ return nullptr; }
+	return static_cast<char *>(region);
+}
+
+SourceBuffer * SourceBuffer::open(const char * path){
+	int fd = ::open(path, O_RDONLY);
+	if (fd < 0){ return nullptr; }
+
+	struct stat info;
+	if (fstat(fd, &info) != 0){
+		close(fd);
+		return nullptr;
+	}
+	if (!S_ISREG(info.st_mode)){
+		//Pipes and devices can't be mapped, so fall
+		// back to reading them into the same layout
+		SourceBuffer * res = readStream(fd);
+		close(fd);
+		return res;
+	}
+
+	size_t size = static_cast<size_t>(info.st_size);
+	size_t mapLen = roundToPage(size + PADDING);
+	char * data = reserve(mapLen);
+	if (data == nullptr){
+		close(fd);
+		return nullptr;
+	}
+
+	//Map the file over the front of the zeroed reservation.
+	// The kernel zero-fills the tail of the last file page,
+	// and any whole pages after it are still anonymous, so
+	// every byte past the end of the file reads as zero.
+	if (size > 0){
+		void * file = mmap(data, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_FIXED, fd, 0);
+		if (file == MAP_FAILED){
+			munmap(data, mapLen);
+			close(fd);
+			return nullptr;
+		}
+		madvise(data, size, MADV_SEQUENTIAL);
+	}
+	close(fd);
+
+	return new SourceBuffer(data, size, mapLen);
+}
+
+SourceBuffer * SourceBuffer::readStream(int fd){
+	std::string contents;
+	char chunk[1 << 16];
+	while (true){
+		ssize_t got = read(fd, chunk, sizeof(chunk));
+		if (got < 0){ return nullptr; }
+		if (got == 0){ break; }
+		contents.append(chunk, static_cast<size_t>(got));
+	}
+
+	size_t mapLen = roundToPage(contents.size() + PADDING);
+	char * data = reserve(mapLen);
+	if (data == nullptr){ return nullptr; }
+	memcpy(data, contents.data(), contents.size());
+	return new SourceBuffer(data, contents.size(), mapLen);
+}
+
+SourceBuffer::~SourceBuffer(){
+	munmap(myData, myMapLen);
+}
+
+}
@@ -0,0 +1,48 @@
+#ifndef HOLEYC_SOURCE_BUFFER_HPP
+#define HOLEYC_SOURCE_BUFFER_HPP
+
+#include <cstddef>
+
+namespace holeyc{
+
+//The entire contents of a source file, mapped into memory
+// once and shared by every phase that needs the raw text.
+// The bytes past the end of the file are guaranteed to be
+// zero for at least PADDING bytes, so flex can use the
+// region in place (it needs two trailing NUL sentinels) and
+// later code can keep pointers into the buffer instead of
+// copying lexemes out of it.
+class SourceBuffer{
+public:
+	//Number of zero bytes guaranteed after the last byte
+	// of the file.
+	static const size_t PADDING = 64;
+
+	//Open and map the file at path. Returns nullptr if
+	// the file could not be opened or read.
+	static SourceBuffer * open(const char * path);
+	~SourceBuffer();
+
+	const char * data() const { return myData; }
+	size_t size() const { return mySize; }
+	const char * end() const { return myData + mySize; }
+
+	//A writable view of the buffer, including the
+	// trailing sentinels. Flex temporarily overwrites
+	// the byte after each match, so the mapping is
+	// private (copy-on-write) and the file on disk is
+	// never touched.
+	char * scanBuffer(){ return myData; }
+private:
+	SourceBuffer(char * dataIn, size_t sizeIn, size_t mapLenIn)
+	: myData(dataIn), mySize(sizeIn), myMapLen(mapLenIn){ }
+	static SourceBuffer * readStream(int fd);
+
+	char * myData;
+	size_t mySize;
+	size_t myMapLen;
+};
+
+}
+
+#endif
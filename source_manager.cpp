@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <string.h>
+
+#include "source_manager.hpp"
+#include "errors.hpp"
+
+namespace holeyc{
+
+SourceManager::SourceManager(const SourceBuffer * src)
+: mySrc(src), myLastLine(0){ }
+
+size_t SourceManager::lineIndex(size_t offset) const {
+	if (myLineStarts.empty()){
+		//A newline ends a line whatever came before it ("\r\n"
+		// included), so the starts are just the offsets after
+		// each newline
+		const char * data = mySrc->data();
+		const char * end = mySrc->end();
+		myLineStarts.push_back(0);
+		const char * p = data;
+		while (p < end){
+			const void * nl = memchr(p, '\n', static_cast<size_t>(end - p));
+			if (nl == nullptr){ break; }
+			p = static_cast<const char *>(nl) + 1;
+			myLineStarts.push_back(static_cast<uint32_t>(p - data));
+		}
+	}
+
+	size_t count = myLineStarts.size();
+	size_t last = myLastLine;
+	if (offset >= myLineStarts[last]){
+		if (last + 1 == count || offset < myLineStarts[last + 1]){
+			return last;
+		}
+		if (last + 2 == count || offset < myLineStarts[last + 2]){
+			myLastLine = last + 1;
+			return myLastLine;
+		}
+	}
+	auto after = std::upper_bound(myLineStarts.begin(),
+		myLineStarts.end(), offset);
+	myLastLine = static_cast<size_t>(after - myLineStarts.begin()) - 1;
+	return myLastLine;
+}
+
+size_t SourceManager::line(size_t offset) const {
+	return lineIndex(offset) + 1;
+}
+
+size_t SourceManager::col(size_t offset) const {
+	size_t start = myLineStarts[lineIndex(offset)];
+	if (!myRestarts.empty() && offset >= myRestarts.front()){
+		auto after = std::upper_bound(myRestarts.begin(),
+			myRestarts.end(), offset);
+		size_t restart = *(after - 1);
+		if (restart > start){ start = restart; }
+	}
+	return offset - start + 1;
+}
+
+void SourceManager::restartColumn(size_t offset){
+	uint32_t at = static_cast<uint32_t>(offset);
+	if (myRestarts.empty() || at > myRestarts.back()){
+		myRestarts.push_back(at);
+	} else if (!std::binary_search(myRestarts.begin(),
+	  myRestarts.end(), at)){
+		throw new InternalError("Column restarts out of order");
+	}
+}
+
+}
@@ -0,0 +1,77 @@
+#ifndef HOLEYC_SOURCE_MANAGER_HPP
+#define HOLEYC_SOURCE_MANAGER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "source_buffer.hpp"
+
+namespace holeyc{
+
+//Turns byte offsets into a source file into the line and
+// column numbers that diagnostics and the token listing show.
+// Tokens and AST nodes only carry a 32-bit offset; the table
+// of line starts is built the first time a position is asked
+// for, and most runs never ask.
+//
+//Columns count bytes from 1, except that a column restarts
+// at 1 where the scanner says so (see restartColumn). That
+// keeps the positions the flex scanner has always given
+// after an unterminated string literal.
+//
+//Not thread-safe: each compilation has its own, used on the
+// thread it is installed on (see SourceScope).
+class SourceManager{
+public:
+	//Offsets are 32 bits, so anything that makes tokens from
+	// src must first check that it is under MAX_SIZE
+	static const size_t MAX_SIZE = UINT32_MAX;
+	explicit SourceManager(const SourceBuffer * src);
+
+	size_t line(size_t offset) const;
+	size_t col(size_t offset) const;
+
+	//From offset to the end of its line, count columns from
+	// offset rather than from the start of the line. Calls
+	// must come in increasing order of offset, apart from
+	// repeats (a file lexed twice restarts at the same
+	// places twice).
+	void restartColumn(size_t offset);
+
+	//The manager installed on this thread, if any
+	static SourceManager * current(){ return installed(); }
+private:
+	friend class SourceScope;
+	static SourceManager *& installed(){
+		static thread_local SourceManager * theManager = nullptr;
+		return theManager;
+	}
+	//The index into myLineStarts of offset's line
+	size_t lineIndex(size_t offset) const;
+
+	const SourceBuffer * mySrc;
+	//Offsets at which each line starts, built on demand
+	mutable std::vector<uint32_t> myLineStarts;
+	//The line last looked up. Positions are mostly asked for
+	// in source order, so the answer is usually this line or
+	// the next.
+	mutable size_t myLastLine;
+	std::vector<uint32_t> myRestarts;
+};
+
+//Installs a manager on the current thread for its lifetime
+class SourceScope{
+public:
+	SourceScope(SourceManager * manager)
+	: myPrev(SourceManager::installed()){
+		SourceManager::installed() = manager;
+	}
+	~SourceScope(){ SourceManager::installed() = myPrev; }
+private:
+	SourceManager * myPrev;
+};
+
+}
+
+#endif
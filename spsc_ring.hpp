@@ -0,0 +1,77 @@
+#ifndef HOLEYC_SPSC_RING_HPP
+#define HOLEYC_SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace holeyc{
+
+//A bounded, lock-free queue for exactly one producer thread
+// and one consumer thread. Each side owns one index and only
+// reads the other's; each also keeps a private copy of the
+// other side's index so it only touches the shared cache
+// line when the ring looks full (or empty).
+template <typename T>
+class SpscRing{
+public:
+	//capacity is rounded up to a power of two
+	SpscRing(size_t capacity) : myHead(0), myTail(0){
+		size_t cap = 2;
+		while (cap < capacity){ cap *= 2; }
+		mySlots.resize(cap);
+		myMask = cap - 1;
+		myCachedHead = 0;
+		myCachedTail = 0;
+	}
+
+	//Producer side. Returns false if the ring is full.
+	bool tryPush(const T& item){
+		size_t tail = myTail.load(std::memory_order_relaxed);
+		if (tail - myCachedHead > myMask){
+			myCachedHead = myHead.load(std::memory_order_acquire);
+			if (tail - myCachedHead > myMask){ return false; }
+		}
+		mySlots[tail & myMask] = item;
+		myTail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	//Consumer side. Returns false if the ring is empty.
+	bool tryPop(T& item){
+		size_t head = myHead.load(std::memory_order_relaxed);
+		if (head == myCachedTail){
+			myCachedTail = myTail.load(std::memory_order_acquire);
+			if (head == myCachedTail){ return false; }
+		}
+		item = mySlots[head & myMask];
+		myHead.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	//Blocking pop: spin briefly, then yield the core to the
+	// producer
+	void pop(T& item){
+		for (unsigned spins = 0; !tryPop(item); spins++){
+			if (spins > 64){ std::this_thread::yield(); }
+		}
+	}
+private:
+	//Keep the two sides' indices a cache line apart so they
+	// don't bounce between cores. (Padding rather than 
+	// alignas, which would need C++17 aligned new.)
+	static const size_t LINE = 64;
+	std::atomic<size_t> myHead;
+	size_t myCachedTail;
+	char myConsumerPad[LINE];
+	std::atomic<size_t> myTail;
+	size_t myCachedHead;
+	char myProducerPad[LINE];
+	std::vector<T> mySlots;
+	size_t myMask;
+};
+
+}
+
+#endif
@@ -3,24 +3,23 @@
 #include "types.hpp"
 namespace holeyc{
 
-SymbolTable::SymbolTable(){
+ScopeChainTable::ScopeChainTable(){
 	scopeTableChain = new std::list<ScopeTable *>();
 }
 
-void SymbolTable::print(){
+void ScopeChainTable::print(){
 	for(auto scope : *scopeTableChain){
 		std::cout << "--- scope ---\n";
 		std::cout << scope->toString();
 	}
 }
 
-ScopeTable * SymbolTable::enterScope(){
+void ScopeChainTable::enterScope(){
 	ScopeTable * newScope = new ScopeTable();
 	scopeTableChain->push_front(newScope);
-	return newScope;
 }
 
-void SymbolTable::leaveScope(){
+void ScopeChainTable::leaveScope(){
 	if (scopeTableChain->empty()){
 		throw new InternalError("Attempt to pop"
 			"empty symbol table");
@@ -28,16 +27,16 @@ void SymbolTable::leaveScope(){
 	scopeTableChain->pop_front();
 }
 
-ScopeTable * SymbolTable::getCurrentScope(){
+ScopeTable * ScopeChainTable::getCurrentScope(){
 	return scopeTableChain->front();
 }
 
-bool SymbolTable::clash(std::string varName){
+bool ScopeChainTable::clash(NameID varName){
 	bool hasClash = getCurrentScope()->clash(varName);
 	return hasClash;
 }
 
-SemSymbol * SymbolTable::find(std::string varName){
+SemSymbol * ScopeChainTable::find(NameID varName){
 	for (ScopeTable * scope : *scopeTableChain){
 		SemSymbol * sym = scope->lookup(varName);
 		if (sym != nullptr) { return sym; }
@@ -45,12 +44,70 @@ SemSymbol * SymbolTable::find(std::string varName){
 	return nullptr;
 }
 
-bool SymbolTable::insert(SemSymbol * symbol){
+bool ScopeChainTable::insert(SemSymbol * symbol){
 	return scopeTableChain->front()->insert(symbol);
 }
 
+void ScopeStackTable::enterScope(){
+	scopeStarts.push_back(undoLog.size());
+}
+
+void ScopeStackTable::leaveScope(){
+	if (scopeStarts.empty()){
+		throw new InternalError("Attempt to pop"
+			"empty symbol table");
+	}
+	size_t start = scopeStarts.back();
+	scopeStarts.pop_back();
+	while (undoLog.size() > start){
+		SemSymbol * sym = undoLog.back();
+		undoLog.pop_back();
+		//Keep the emptied stack; the name is likely to
+		// be bound again by a sibling scope
+		bindings[sym->getNameID()].pop_back();
+	}
+}
+
+SemSymbol * ScopeStackTable::find(NameID varName){
+	auto found = bindings.find(varName);
+	if (found == bindings.end() || found->second.empty()){
+		return nullptr;
+	}
+	return found->second.back().symbol;
+}
+
+bool ScopeStackTable::clash(NameID name){
+	auto found = bindings.find(name);
+	if (found == bindings.end() || found->second.empty()){
+		return false;
+	}
+	return found->second.back().depth == depth();
+}
+
+bool ScopeStackTable::insert(SemSymbol * symbol){
+	std::vector<Binding>& stack = bindings[symbol->getNameID()];
+	if (!stack.empty() && stack.back().depth == depth()){
+		return false;
+	}
+	Binding binding = {symbol, depth()};
+	stack.push_back(binding);
+	undoLog.push_back(symbol);
+	return true;
+}
+
+void ScopeStackTable::print(){
+	size_t end = undoLog.size();
+	for (size_t i = scopeStarts.size(); i > 0; i--){
+		std::cout << "--- scope ---\n";
+		for (size_t j = scopeStarts[i - 1]; j < end; j++){
+			std::cout << undoLog[j]->toString() << "\n";
+		}
+		end = scopeStarts[i - 1];
+	}
+}
+
 ScopeTable::ScopeTable(){
-	symbols = new HashMap<std::string, SemSymbol *>();
+	symbols = Arena::current()->make<SymbolMap>();
 }
 
 std::string ScopeTable::toString(){
@@ -62,7 +119,7 @@ std::string ScopeTable::toString(){
 	return result;
 }
 
-bool ScopeTable::clash(std::string varName){
+bool ScopeTable::clash(NameID varName){
 	SemSymbol * found = lookup(varName);
 	if (found != nullptr){
 		return true;
@@ -70,7 +127,7 @@ bool ScopeTable::clash(std::string varName){
 	return false;
 }
 
-SemSymbol * ScopeTable::lookup(std::string name){
+SemSymbol * ScopeTable::lookup(NameID name){
 	auto found = symbols->find(name);
 	if (found == symbols->end()){
 		return NULL;
@@ -79,7 +136,7 @@ SemSymbol * ScopeTable::lookup(std::string name){
 }
 
 bool ScopeTable::insert(SemSymbol * symbol){
-	std::string symName = symbol->getName();
+	NameID symName = symbol->getNameID();
 	bool alreadyInScope = (this->lookup(symName) != NULL);
 	if (alreadyInScope){
 		return false;
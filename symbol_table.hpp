@@ -3,14 +3,18 @@
 #include <string>
 #include <unordered_map>
 #include <list>
+#include <vector>
 #include "types.hpp"
+#include "intern_table.hpp"
+#include "arena.hpp"
+#include "node_map.hpp"
 
 //Use an alias template so that we can use
 // "HashMap" and it means "std::unordered_map"
 template <typename K, typename V>
 using HashMap = std::unordered_map<K, V>;
 
-using ArgsType = std::list<const holeyc::DataType *>;
+using ArgsType = std::vector<const holeyc::DataType *>;
 
 using namespace std;
 
@@ -26,10 +30,18 @@ enum SymbolKind {
 // symbol table. 
 class SemSymbol {
 public:
-	SemSymbol(std::string nameIn, DataType * typeIn) 
+	SemSymbol(NameID nameIn, DataType * typeIn) 
 	: myName(nameIn), myType(typeIn){ }
+	//Symbols live in the current Arena, like the AST
+	static void * operator new(size_t size){
+		return Arena::current()->allocate(size);
+	}
+	static void operator delete(void *){ }
 	virtual std::string toString();
-	std::string getName() const { return myName; }
+	NameID getNameID() const { return myName; }
+	const std::string& getName() const { 
+		return InternTable::global()->name(myName);
+	}
 	virtual SymbolKind getKind() const = 0;
 
 	virtual DataType * getDataType() const{
@@ -43,20 +55,20 @@ public:
 		return "UNKNOWN KIND";
 	} 
 private:
-	std::string myName;
+	NameID myName;
 	DataType * myType;
 };
 
 class VarSymbol : public SemSymbol {
 public:
-	VarSymbol(std::string name, DataType * type) 
+	VarSymbol(NameID name, DataType * type) 
 	: SemSymbol(name, type) { }
 	virtual SymbolKind getKind() const override { return VAR; } 
 };
 
 class FnSymbol : public SemSymbol{
 public:
-	FnSymbol(std::string name, FnType * fnType)
+	FnSymbol(NameID name, FnType * fnType)
 	: SemSymbol(name, fnType){ }
 	virtual SymbolKind getKind() const { return FN; }
 	SymbolKind getKind(){ return FN; } 
@@ -71,40 +83,108 @@ public:
 class ScopeTable {
 	public:
 		ScopeTable();
-		SemSymbol * lookup(std::string name);
+		static void * operator new(size_t size){
+			return Arena::current()->allocate(size);
+		}
+		static void operator delete(void *){ }
+		SemSymbol * lookup(NameID name);
 		bool insert(SemSymbol * symbol);
-		bool clash(std::string name);
+		bool clash(NameID name);
 		std::string toString();
-		void addVar(std::string name, DataType * type){
+		void addVar(NameID name, DataType * type){
 			insert(new VarSymbol(name, type));
 		}
-		void addFn(std::string name, FnType * type){
+		void addFn(NameID name, FnType * type){
 			insert(new FnSymbol(name, type));
 		}
 	private:
-		HashMap<std::string, SemSymbol *> * symbols;
+		//Keyed on interned names, so a lookup hashes
+		// an integer rather than the identifier's text.
+		// The map's nodes are in the arena as well.
+		using SymbolMap = std::unordered_map<NameID, SemSymbol *,
+			std::hash<NameID>, std::equal_to<NameID>,
+			ArenaAllocator<std::pair<const NameID, SemSymbol *>>>;
+		SymbolMap * symbols;
 };
 
+//The stack of scopes visible at a point in the program.
+// There are two implementations: ScopeChainTable, which
+// keeps a ScopeTable per scope and searches them innermost
+// first, and ScopeStackTable, which keeps a single table of
+// bindings for the whole stack.
+//
+//The table also records which symbol each ID use resolved
+// to, for the later passes.
 class SymbolTable{
 	public:
-		SymbolTable();
-		ScopeTable * enterScope();
-		void leaveScope();
-		ScopeTable * getCurrentScope();
-		bool insert(SemSymbol * symbol);
-		SemSymbol * find(std::string varName);
-		bool clash(std::string name);
-		void addVar(std::string name, DataType * type){
-			getCurrentScope()->addVar(name, type);
+		SymbolTable()
+		: myResolved(Arena::current()->nodeCount()){ }
+		virtual ~SymbolTable(){ }
+		virtual void enterScope() = 0;
+		virtual void leaveScope() = 0;
+		//Add symbol to the innermost scope. Returns
+		// false if that scope already has the name
+		virtual bool insert(SemSymbol * symbol) = 0;
+		//The innermost visible symbol named varName
+		virtual SemSymbol * find(NameID varName) = 0;
+		//Whether the innermost scope declares name
+		virtual bool clash(NameID name) = 0;
+		void addVar(NameID name, DataType * type){
+			insert(new VarSymbol(name, type));
+		}
+		void addFn(NameID name, FnType * type){
+			insert(new FnSymbol(name, type));
 		}
-		void addFn(std::string name, FnType * type){
-			getCurrentScope()->addFn(name, type);
+		virtual void print() = 0;
+
+		void resolve(const ASTNode * use, SemSymbol * sym){
+			myResolved.set(use, sym);
 		}
-		void print();
+		NodeMap<SemSymbol *>& resolved(){ return myResolved; }
+	private:
+		NodeMap<SemSymbol *> myResolved;
+};
+
+class ScopeChainTable : public SymbolTable{
+	public:
+		ScopeChainTable();
+		void enterScope() override;
+		void leaveScope() override;
+		ScopeTable * getCurrentScope();
+		bool insert(SemSymbol * symbol) override;
+		SemSymbol * find(NameID varName) override;
+		bool clash(NameID name) override;
+		void print() override;
 	private:
 		std::list<ScopeTable *> * scopeTableChain;
 };
 
+//LeBlanc-Cook style table: each name maps to the stack of
+// its bindings, innermost last, so find is one hash probe
+// however deep the nesting. Each scope logs the symbols it
+// inserted, and leaveScope pops exactly those.
+class ScopeStackTable : public SymbolTable{
+	public:
+		ScopeStackTable(){ }
+		void enterScope() override;
+		void leaveScope() override;
+		bool insert(SemSymbol * symbol) override;
+		SemSymbol * find(NameID varName) override;
+		bool clash(NameID name) override;
+		void print() override;
+	private:
+		struct Binding{
+			SemSymbol * symbol;
+			size_t depth;
+		};
+		size_t depth() const { return scopeStarts.size(); }
+
+		HashMap<NameID, std::vector<Binding>> bindings;
+		//Every symbol inserted by the open scopes, in order
+		std::vector<SemSymbol *> undoLog;
+		//Where each open scope's entries in undoLog begin
+		std::vector<size_t> scopeStarts;
+};
 	
 }
 
@@ -0,0 +1,57 @@
+#include "thread_pool.hpp"
+
+namespace holeyc{
+
+ThreadPool::ThreadPool(size_t numThreads)
+: myPending(0), myStopping(false){
+	if (numThreads == 0){ numThreads = 1; }
+	for (size_t i = 0; i < numThreads; i++){
+		myWorkers.push_back(std::thread(&ThreadPool::work, this));
+	}
+}
+
+ThreadPool::~ThreadPool(){
+	{
+		std::lock_guard<std::mutex> guard(myLock);
+		myStopping = true;
+	}
+	myWorkReady.notify_all();
+	for (std::thread& worker : myWorkers){
+		worker.join();
+	}
+}
+
+void ThreadPool::submit(std::function<void()> task){
+	{
+		std::lock_guard<std::mutex> guard(myLock);
+		myTasks.push_back(std::move(task));
+		myPending++;
+	}
+	myWorkReady.notify_one();
+}
+
+void ThreadPool::wait(){
+	std::unique_lock<std::mutex> guard(myLock);
+	myAllDone.wait(guard, [this]{ return myPending == 0; });
+}
+
+void ThreadPool::work(){
+	while (true){
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> guard(myLock);
+			myWorkReady.wait(guard, [this]{ 
+				return myStopping || !myTasks.empty();
+			});
+			if (myTasks.empty()){ return; }
+			task = std::move(myTasks.front());
+			myTasks.pop_front();
+		}
+		task();
+		std::lock_guard<std::mutex> guard(myLock);
+		myPending--;
+		if (myPending == 0){ myAllDone.notify_all(); }
+	}
+}
+
+}
@@ -0,0 +1,37 @@
+#ifndef HOLEYC_THREAD_POOL_HPP
+#define HOLEYC_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace holeyc{
+
+//A fixed set of worker threads that run submitted tasks.
+// wait() blocks until every task submitted so far has
+// finished, so a pool can be reused for several rounds.
+class ThreadPool{
+public:
+	ThreadPool(size_t numThreads);
+	~ThreadPool();
+	void submit(std::function<void()> task);
+	void wait();
+	size_t size() const { return myWorkers.size(); }
+private:
+	void work();
+
+	std::vector<std::thread> myWorkers;
+	std::deque<std::function<void()>> myTasks;
+	std::mutex myLock;
+	std::condition_variable myWorkReady;
+	std::condition_variable myAllDone;
+	size_t myPending;
+	bool myStopping;
+};
+
+}
+
+#endif
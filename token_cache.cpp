@@ -0,0 +1,322 @@
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+#include "token_cache.hpp"
+#include "simd_lexer.hpp"
+#include "grammar.hh"
+
+namespace holeyc{
+
+using TokenKind = holeyc::Parser::token;
+
+//Bump this whenever the record layout or the lexer's output
+// changes, so that old cache files miss
+static const uint32_t CACHE_VERSION = 2;
+static const char CACHE_MAGIC[8] = {'H','C','T','O','K','E','N','S'};
+
+//Starts every cache file. The spelling table follows the
+// records: stringCount uint32 lengths, then the spellings
+// back to back (stringBytes in all).
+struct CacheHeader{
+	char magic[8];
+	uint32_t version;
+	uint32_t recordSize;
+	uint64_t sourceHash;
+	uint64_t sourceSize;
+	uint64_t tokenCount;
+	uint64_t stringCount;
+	uint64_t stringBytes;
+};
+
+//FNV-1a over 8-byte words, then the tail. Only needs to tell
+// files apart, not to resist anyone trying to collide it.
+static uint64_t contentHash(const char * data, size_t len){
+	const uint64_t PRIME = 0x100000001b3ull;
+	uint64_t h = 0xcbf29ce484222325ull;
+	size_t i = 0;
+	for (; i + 8 <= len; i += 8){
+		uint64_t word;
+		memcpy(&word, data + i, 8);
+		h = (h ^ word) * PRIME;
+		h ^= h >> 29;
+	}
+	for (; i < len; i++){
+		h = (h ^ static_cast<unsigned char>(data[i])) * PRIME;
+	}
+	return h ^ (h >> 32);
+}
+
+//Whether a record's payload is the length of its text
+static bool hasText(int kind){
+	return kind == TokenKind::STRLITERAL || kind == LEXERR_ILLEGAL
+		|| kind == LEXERR_STR_UNTERM || kind == LEXERR_STR_ESC_UNTERM;
+}
+
+static std::string cachePath(const char * dir, uint64_t hash){
+	static const char HEX[] = "0123456789abcdef";
+	std::string name(16, '0');
+	for (size_t i = 0; i < 16; i++){
+		name[15 - i] = HEX[(hash >> (4 * i)) & 0xf];
+	}
+	return std::string(dir) + "/" + name + ".htc";
+}
+
+TokenCache * TokenCache::get(const char * dir, const SourceBuffer * src){
+	//Offsets are stored in 32 bits
+	if (src->size() >= UINT32_MAX){ return build(src); }
+
+	uint64_t hash = contentHash(src->data(), src->size());
+	std::string path = cachePath(dir, hash);
+	TokenCache * cache = open(path, src, hash);
+	if (cache != nullptr){ return cache; }
+
+	cache = build(src);
+	cache->store(path, hash);
+	return cache;
+}
+
+TokenCache::~TokenCache(){
+	if (myMap != nullptr){ munmap(myMap, myMapLen); }
+}
+
+TokenCache * TokenCache::open(const std::string& path,
+  const SourceBuffer * src, uint64_t hash){
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0){ return nullptr; }
+	struct stat info;
+	if (fstat(fd, &info) != 0
+	  || static_cast<size_t>(info.st_size) < sizeof(CacheHeader)){
+		close(fd);
+		return nullptr;
+	}
+	size_t len = static_cast<size_t>(info.st_size);
+	void * map = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED){ return nullptr; }
+
+	TokenCache * cache = new TokenCache(src);
+	cache->myMap = map;
+	cache->myMapLen = len;
+
+	//Check that the file is what its name says, and that
+	// everything in it is in bounds, before trusting it
+	const char * bytes = static_cast<const char *>(map);
+	CacheHeader header;
+	memcpy(&header, bytes, sizeof(header));
+	size_t srcSize = src->size();
+	bool ok = memcmp(header.magic, CACHE_MAGIC, 8) == 0
+	  && header.version == CACHE_VERSION
+	  && header.recordSize == sizeof(Record)
+	  && header.sourceHash == hash
+	  && header.sourceSize == srcSize
+	  && header.tokenCount > 0
+	  && header.tokenCount <= len / sizeof(Record)
+	  && header.stringCount <= len / sizeof(uint32_t)
+	  && header.stringBytes <= len;
+	size_t recordBytes = 0;
+	size_t lensBytes = 0;
+	if (ok){
+		recordBytes = header.tokenCount * sizeof(Record);
+		lensBytes = header.stringCount * sizeof(uint32_t);
+		ok = sizeof(header) + recordBytes + lensBytes
+		  + header.stringBytes == len;
+	}
+	if (!ok){
+		delete cache;
+		return nullptr;
+	}
+
+	const uint32_t * lens = reinterpret_cast<const uint32_t *>(
+		bytes + sizeof(header) + recordBytes);
+	const char * text = bytes + sizeof(header) + recordBytes + lensBytes;
+	const char * textEnd = text + header.stringBytes;
+	cache->myNames.reserve(header.stringCount);
+	cache->myNameLens.reserve(header.stringCount);
+	InternTable * names = InternTable::global();
+	for (size_t i = 0; i < header.stringCount; i++){
+		if (lens[i] > static_cast<size_t>(textEnd - text)){
+			delete cache;
+			return nullptr;
+		}
+		cache->myNames.push_back(names->intern(text, lens[i]));
+		cache->myNameLens.push_back(lens[i]);
+		text += lens[i];
+	}
+
+	const Record * records = reinterpret_cast<const Record *>(
+		bytes + sizeof(header));
+	for (size_t i = 0; i < header.tokenCount; i++){
+		const Record& rec = records[i];
+		bool inBounds = rec.offset <= srcSize;
+		if (rec.kind == TokenKind::ID){
+			inBounds = inBounds && rec.payload < header.stringCount;
+		} else if (hasText(rec.kind)){
+			inBounds = inBounds && rec.payload <= srcSize - rec.offset;
+		}
+		if (!inBounds){
+			delete cache;
+			return nullptr;
+		}
+	}
+	if (records[header.tokenCount - 1].kind != TokenKind::END){
+		delete cache;
+		return nullptr;
+	}
+	cache->myRecords = records;
+	cache->myCount = header.tokenCount;
+	return cache;
+}
+
+TokenCache * TokenCache::build(const SourceBuffer * src){
+	TokenCache * cache = new TokenCache(src);
+	std::unordered_map<NameID, uint32_t> index;
+	//A rough guess at token density avoids most regrowth
+	cache->myOwned.reserve(src->size() / 4 + 1);
+	SimdLexer lexer(src);
+	RawToken tok;
+	do {
+		lexer.next(tok);
+		Record rec = Record();
+		rec.kind = tok.kind;
+		rec.offset = tok.offset;
+		switch (tok.kind){
+		case TokenKind::ID: {
+			auto found = index.find(tok.name);
+			if (found == index.end()){
+				uint32_t next = static_cast<uint32_t>(
+					cache->myNames.size());
+				found = index.emplace(tok.name, next).first;
+				cache->myNames.push_back(tok.name);
+				cache->myNameLens.push_back(
+					static_cast<uint32_t>(tok.len));
+			}
+			rec.payload = found->second;
+			break;
+		}
+		case TokenKind::STRLITERAL:
+		case LEXERR_ILLEGAL:
+		case LEXERR_STR_UNTERM:
+		case LEXERR_STR_ESC_UNTERM:
+			rec.payload = static_cast<uint32_t>(tok.len);
+			break;
+		case TokenKind::INTLITERAL:
+		case LEXERR_INT_OVERFLOW:
+			rec.payload = static_cast<uint32_t>(tok.intVal);
+			break;
+		case TokenKind::CHARLIT:
+			rec.payload = static_cast<unsigned char>(tok.charVal);
+			break;
+		default:
+			break;
+		}
+		cache->myOwned.push_back(rec);
+	} while (tok.kind != TokenKind::END);
+	cache->myRecords = cache->myOwned.data();
+	cache->myCount = cache->myOwned.size();
+	return cache;
+}
+
+static bool writeAll(int fd, const void * data, size_t len){
+	const char * bytes = static_cast<const char *>(data);
+	while (len > 0){
+		ssize_t wrote = ::write(fd, bytes, len);
+		if (wrote < 0){ return false; }
+		bytes += wrote;
+		len -= static_cast<size_t>(wrote);
+	}
+	return true;
+}
+
+bool TokenCache::store(const std::string& path, uint64_t hash) const {
+	CacheHeader header;
+	memcpy(header.magic, CACHE_MAGIC, 8);
+	header.version = CACHE_VERSION;
+	header.recordSize = sizeof(Record);
+	header.sourceHash = hash;
+	header.sourceSize = mySrc->size();
+	header.tokenCount = myCount;
+	header.stringCount = myNames.size();
+	header.stringBytes = 0;
+	for (uint32_t len : myNameLens){ header.stringBytes += len; }
+
+	//Write to a temporary file and rename it into place, so
+	// that a concurrent run never maps a half-written entry
+	std::string tmpPath = path + ".XXXXXX";
+	std::vector<char> tmpName(tmpPath.begin(), tmpPath.end());
+	tmpName.push_back('\0');
+	int fd = mkstemp(tmpName.data());
+	if (fd < 0){ return false; }
+	//mkstemp makes the file private to us; the cache is not
+	bool ok = fchmod(fd, 0644) == 0
+	  && writeAll(fd, &header, sizeof(header))
+	  && writeAll(fd, myRecords, myCount * sizeof(Record))
+	  && writeAll(fd, myNameLens.data(),
+	    myNameLens.size() * sizeof(uint32_t));
+	InternTable * names = InternTable::global();
+	for (size_t i = 0; ok && i < myNames.size(); i++){
+		const std::string& name = names->name(myNames[i]);
+		ok = writeAll(fd, name.data(), name.size());
+	}
+	ok = close(fd) == 0 && ok;
+	if (ok && rename(tmpName.data(), path.c_str()) == 0){
+		return true;
+	}
+	unlink(tmpName.data());
+	return false;
+}
+
+//Replays a TokenCache's records as RawTokens
+class CachedTokenStream : public TokenStream{
+public:
+	CachedTokenStream(const TokenCache * cacheIn)
+	: myCache(cacheIn), myIndex(0){ }
+	void next(RawToken& tok) override;
+private:
+	const TokenCache * myCache;
+	size_t myIndex;
+};
+
+void CachedTokenStream::next(RawToken& tok){
+	const TokenCache::Record& rec = myCache->myRecords[myIndex];
+	if (myIndex + 1 < myCache->myCount){ myIndex++; }
+
+	tok = RawToken();
+	tok.kind = rec.kind;
+	tok.offset = rec.offset;
+	const char * text = myCache->mySrc->data() + rec.offset;
+	switch (rec.kind){
+	case TokenKind::ID:
+		tok.name = myCache->myNames[rec.payload];
+		tok.text = text;
+		tok.len = myCache->myNameLens[rec.payload];
+		break;
+	case TokenKind::STRLITERAL:
+	case LEXERR_ILLEGAL:
+	case LEXERR_STR_UNTERM:
+	case LEXERR_STR_ESC_UNTERM:
+		tok.text = text;
+		tok.len = rec.payload;
+		break;
+	case TokenKind::INTLITERAL:
+	case LEXERR_INT_OVERFLOW:
+		tok.intVal = static_cast<int>(rec.payload);
+		break;
+	case TokenKind::CHARLIT:
+		tok.charVal = static_cast<char>(rec.payload);
+		break;
+	default:
+		break;
+	}
+}
+
+TokenStream * TokenCache::stream() const {
+	return new CachedTokenStream(this);
+}
+
+}
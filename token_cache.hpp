@@ -0,0 +1,80 @@
+#ifndef HOLEYC_TOKEN_CACHE_HPP
+#define HOLEYC_TOKEN_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "intern_table.hpp"
+#include "source_buffer.hpp"
+#include "token_stream.hpp"
+
+namespace holeyc{
+
+//The token stream of one source file, saved on disk so that
+// an unchanged file need not be lexed again. Cache files are
+// named by a hash of the file's contents, so a file that
+// changes simply misses, and files with the same contents
+// share an entry wherever they live.
+//
+//A cache file holds one fixed-size record per token, lexical
+// errors included, followed by a table of the distinct
+// identifier spellings. On a hit the file is mapped and read
+// in place; the only work done up front is interning each
+// spelling once.
+class TokenCache{
+public:
+	//The tokens of src, from the cache in dir if it has a
+	// matching entry. Otherwise src is lexed (with a
+	// SimdLexer, which matches the flex scanner exactly) and
+	// the result written to dir for next time; failing to
+	// write it just means the next run lexes again.
+	static TokenCache * get(const char * dir, const SourceBuffer * src);
+	~TokenCache();
+	TokenCache(const TokenCache&) = delete;
+	TokenCache& operator=(const TokenCache&) = delete;
+
+	//Whether get() found the tokens on disk
+	bool hit() const { return myMap != nullptr; }
+
+	//A fresh stream over the cached tokens, for a Scanner.
+	// It ends by repeating the END token.
+	TokenStream * stream() const;
+
+	//One token on disk, at offset in the source. For text
+	// (string literals, illegal characters and unterminated
+	// strings) payload is the length; for an ID it indexes the
+	// spelling table; for an integer or character literal it
+	// is the value.
+	struct Record{
+		int32_t kind;
+		uint32_t offset;
+		uint32_t payload;
+	};
+private:
+	friend class CachedTokenStream;
+	TokenCache(const SourceBuffer * srcIn)
+	: mySrc(srcIn), myMap(nullptr), myMapLen(0),
+	  myRecords(nullptr), myCount(0){ }
+	static TokenCache * open(const std::string& path,
+	  const SourceBuffer * src, uint64_t hash);
+	static TokenCache * build(const SourceBuffer * src);
+	bool store(const std::string& path, uint64_t hash) const;
+
+	const SourceBuffer * mySrc;
+	//The mapped cache file on a hit...
+	void * myMap;
+	size_t myMapLen;
+	//...or the records made by lexing on a miss
+	std::vector<Record> myOwned;
+	const Record * myRecords;
+	size_t myCount;
+
+	//Each spelling's NameID in this process, and its length
+	std::vector<NameID> myNames;
+	std::vector<uint32_t> myNameLens;
+};
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef HOLEYC_TOKEN_STREAM_HPP
+#define HOLEYC_TOKEN_STREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "intern_table.hpp"
+
+namespace holeyc{
+
+//Lexical errors are carried through a token stream in
+// order with the tokens, so that whoever consumes the
+// stream (normally the Scanner) reports them at the same
+// point the flex scanner would have.
+enum LexErr{
+	LEXERR_ILLEGAL = -1,
+	LEXERR_CHR_ESC_EMPTY = -2,
+	LEXERR_CHR_EMPTY = -3,
+	LEXERR_CHR_ESC = -4,
+	LEXERR_STR_ESC = -5,
+	LEXERR_STR_UNTERM = -6,
+	LEXERR_STR_ESC_UNTERM = -7,
+	LEXERR_INT_OVERFLOW = -8
+};
+
+//A token as produced by a lexer, before it is turned into
+// a parser semantic value. kind is a TokenKind, or one of
+// the LexErr codes above, and offset is where it starts in
+// the source (see SourceManager for its line and column).
+// text/len point into the source buffer (for IDs, string
+// literals, illegal characters and unterminated strings) and
+// are never copied. IDs are also interned by the lexer, so
+// that the name is ready for the parser.
+struct RawToken{
+	int kind;
+	uint32_t offset;
+	const char * text;
+	size_t len;
+	NameID name;
+	int intVal;
+	char charVal;
+};
+
+//Anything that can hand out RawTokens one at a time. The
+// stream ends with a TokenKind::END token, whose offset is
+// the final scanner position: the end of the input, or the
+// start of a comment that runs up to it.
+class TokenStream{
+public:
+	virtual ~TokenStream(){ }
+	virtual void next(RawToken& tok) = 0;
+};
+
+//Replays tokens recorded earlier (see Scanner::recordTokens),
+// so that one lexing pass can feed several consumers. The
+// recording ends with the END token, which keeps coming back
+// if the consumer asks past it.
+class TokenReplay : public TokenStream{
+public:
+	TokenReplay(const std::vector<RawToken> * tokens)
+	: myTokens(tokens), myIndex(0){ }
+
+	void next(RawToken& tok) override{
+		tok = (*myTokens)[myIndex];
+		if (myIndex + 1 < myTokens->size()){ myIndex++; }
+	}
+private:
+	const std::vector<RawToken> * myTokens;
+	size_t myIndex;
+};
+
+}
+
+#endif
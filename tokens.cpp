@@ -1,12 +1,13 @@
 #include "tokens.hpp" // Get the class declarations
 #include "grammar.hh" // Get the TokenKind definitions
+#include "source_manager.hpp"
+#include <utility>
 
 namespace holeyc{
 
 using TokenKind = holeyc::Parser::token;
-using Lexeme = holeyc::Parser::semantic_type;
 
-static std::string tokenKindString(int tokKind){
+static const char * tokenKindString(int tokKind){
 	switch(tokKind){
 		case TokenKind::END: return "EOF";
 		case TokenKind::AND: return "AND";
@@ -60,64 +61,86 @@ static std::string tokenKindString(int tokKind){
 	
 }
 
-Token::Token(size_t lineIn, size_t columnIn, int kindIn)
-  : myLine(lineIn), myCol(columnIn), myKind(kindIn){
+Token::Token(size_t offsetIn, int kindIn)
+  : myOffset(static_cast<uint32_t>(offsetIn)), myKind(kindIn){
 }
 
-std::string Token::toString(){
-	return tokenKindString(kind())
-	+ " [" + std::to_string(line()) 
+std::string Token::toString() const {
+	return tokenKindString(kind()) + posString();
+}
+
+void Token::print(OutBuffer& out) const {
+	out << tokenKindString(kind());
+	printPos(out);
+}
+
+std::string Token::posString() const {
+	return " [" + std::to_string(line()) 
 	+ "," + std::to_string(col()) + "]";
 }
 
+void Token::printPos(OutBuffer& out) const {
+	out << " [" << line() << ',' << col() << ']';
+}
+
 size_t Token::line() const { 
-	return this->myLine; 
+	return SourceManager::current()->line(myOffset); 
 }
 
 size_t Token::col() const { 
-	return this->myCol; 
+	return SourceManager::current()->col(myOffset); 
 }
 
 int Token::kind() const { 
 	return this->myKind; 
 }
 
-IDToken::IDToken(size_t lIn, size_t cIn, std::string vIn)
-  : Token(lIn, cIn, TokenKind::ID), myValue(vIn){ 
+IDToken::IDToken(size_t offsetIn, NameID nameIn)
+  : Token(offsetIn, TokenKind::ID), myName(nameIn){ 
 }
 
-std::string IDToken::toString(){
-	return tokenKindString(kind()) + ":"
-	+ this->myValue
-	+ " [" + std::to_string(line()) 
-	+ "," + std::to_string(col()) + "]";
+std::string IDToken::toString() const {
+	return tokenKindString(kind()) + std::string(":")
+	+ value()
+	+ posString();
 }
 
-const std::string IDToken::value() const { 
-	return this->myValue; 
+void IDToken::print(OutBuffer& out) const {
+	out << tokenKindString(kind()) << ':' << value();
+	printPos(out);
 }
 
-StrToken::StrToken(size_t lIn, size_t cIn, std::string sIn)
-  : Token(lIn, cIn, TokenKind::STRLITERAL), myStr(sIn){
+NameID IDToken::name() const { 
+	return this->myName; 
 }
 
-std::string StrToken::toString(){
-	return tokenKindString(kind()) + ":"
-	+ this->myStr
-	+ " [" + std::to_string(line()) 
-	+ "," + std::to_string(col()) + "]";
+const std::string& IDToken::value() const { 
+	return InternTable::global()->name(myName); 
 }
 
-const std::string StrToken::str() const {
-	return this->myStr;
+StrToken::StrToken(size_t offsetIn, const char * textIn,
+  size_t lenIn)
+  : Token(offsetIn, TokenKind::STRLITERAL), myText(textIn), myLen(lenIn){
 }
 
-CharLitToken::CharLitToken(size_t lIn, size_t cIn, char valIn)
-  : Token(lIn, cIn, TokenKind::CHARLIT), myVal(valIn){
+std::string StrToken::toString() const {
+	return tokenKindString(kind()) + std::string(":")
+	+ std::string(this->myText, this->myLen)
+	+ posString();
 }
 
-std::string CharLitToken::toString() {
-	std::string res = tokenKindString(kind()) + ":";
+void StrToken::print(OutBuffer& out) const {
+	out << tokenKindString(kind()) << ':';
+	out.put(this->myText, this->myLen);
+	printPos(out);
+}
+
+CharLitToken::CharLitToken(size_t offsetIn, char valIn)
+  : Token(offsetIn, TokenKind::CHARLIT), myVal(valIn){
+}
+
+std::string CharLitToken::toString() const {
+	std::string res = tokenKindString(kind()) + std::string(":");
 
 	char v = this->val();
 	if (v == '\n'){ res += "newline"; }
@@ -127,18 +150,31 @@ std::string CharLitToken::toString() {
 	return res;
 }
 
+void CharLitToken::print(OutBuffer& out) const {
+	out << tokenKindString(kind()) << ':';
+
+	char v = this->val();
+	if (v == '\n'){ out << "newline"; }
+	else if (v == '\t'){ out << "tab"; }
+	else { out << v; }
+}
+
 char CharLitToken::val() const {
 	return this->myVal;
 }
 
-IntLitToken::IntLitToken(size_t lIn, size_t cIn, int numIn)
-  : Token(lIn, cIn, TokenKind::INTLITERAL), myNum(numIn){}
+IntLitToken::IntLitToken(size_t offsetIn, int numIn)
+  : Token(offsetIn, TokenKind::INTLITERAL), myNum(numIn){}
 
-std::string IntLitToken::toString(){
-	return tokenKindString(kind()) + ":"
+std::string IntLitToken::toString() const {
+	return tokenKindString(kind()) + std::string(":")
 	+ std::to_string(this->myNum)
-	+ " [" + std::to_string(line()) 
-	+ "," + std::to_string(col()) + "]";
+	+ posString();
+}
+
+void IntLitToken::print(OutBuffer& out) const {
+	out << tokenKindString(kind()) << ':' << this->myNum;
+	printPos(out);
 }
 
 int IntLitToken::num() const {
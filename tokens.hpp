@@ -1,58 +1,88 @@
 #ifndef HOLYC_TOKEN_H
 #define HOLYC_TOKEN_H
 
+#include <cstdint>
 #include <string>
+#include "intern_table.hpp"
+#include "out_buffer.hpp"
 
 namespace holeyc{
 
+//Tokens are passed from the scanner to the parser by value
+// in the parser's variant semantic type, so they are plain
+// trivially copyable objects: no virtual functions and no
+// heap storage (identifiers are interned, and string literals
+// are views into the source). The parser needs to
+// default-construct them as well.
 class Token{
 public:
-	Token(size_t lineIn, size_t columnIn, int kindIn);
-	virtual std::string toString();
+	Token() : myOffset(0), myKind(0){ }
+	Token(size_t offsetIn, int kindIn);
+	std::string toString() const;
+	//Same text as toString, without building a string
+	void print(OutBuffer& out) const;
+	//Where the token starts in the source
+	size_t offset() const { return myOffset; }
+	//Looked up in the current SourceManager
 	size_t line() const;
 	size_t col() const;
 	int kind() const;
+protected:
+	std::string posString() const;
+	void printPos(OutBuffer& out) const;
 private:
-	const size_t myLine;
-	const size_t myCol;
-	const int myKind;
+	uint32_t myOffset;
+	int myKind;
 };
 
 class IDToken : public Token{
 public:
-	IDToken(size_t lIn, size_t cIn, std::string valIn);
-	const std::string value() const;
-	virtual std::string toString() override;
+	IDToken() : Token(), myName(0){ }
+	IDToken(size_t offsetIn, NameID nameIn);
+	NameID name() const;
+	const std::string& value() const;
+	std::string toString() const;
+	void print(OutBuffer& out) const;
 private:
-	const std::string myValue;
+	NameID myName;
 	
 };
 
+//A string literal's text, quotes and escapes included, as a
+// view into the source (which outlives every token)
 class StrToken : public Token{
 public:
-	StrToken(size_t lIn, size_t cIn, std::string valIn);
-	virtual std::string toString() override;
-	const std::string str() const;
+	StrToken() : Token(), myText(nullptr), myLen(0){ }
+	StrToken(size_t offsetIn, const char * textIn, size_t lenIn);
+	std::string toString() const;
+	void print(OutBuffer& out) const;
+	const char * text() const { return myText; }
+	size_t length() const { return myLen; }
 private:
-	const std::string myStr;
+	const char * myText;
+	size_t myLen;
 };
 
 class CharLitToken : public Token{
 public:
-	CharLitToken(size_t lIn, size_t cIn, char valIn);
-	virtual std::string toString() override;
+	CharLitToken() : Token(), myVal(0){ }
+	CharLitToken(size_t offsetIn, char valIn);
+	std::string toString() const;
+	void print(OutBuffer& out) const;
 	char val() const;
 private:
-	const char myVal;
+	char myVal;
 };
 
 class IntLitToken : public Token{
 public:
-	IntLitToken(size_t lIn, size_t cIn, int numIn);
-	virtual std::string toString() override;
+	IntLitToken() : Token(), myNum(0){ }
+	IntLitToken(size_t offsetIn, int numIn);
+	std::string toString() const;
+	void print(OutBuffer& out) const;
 	int num() const;
 private:
-	const int myNum;
+	int myNum;
 };
 
 }
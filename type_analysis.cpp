@@ -4,17 +4,171 @@
 #include "types.hpp"
 #include "name_analysis.hpp"
 #include "type_analysis.hpp"
+#include "ast_visitor.hpp"
 #include <iostream>
 
 namespace holeyc{
 
+namespace{
+
+//What the operator rules need to know about an operand's type
+enum OpdClass : uint8_t {
+	OPD_INT, OPD_BOOL, OPD_OTHER, OPD_ERROR, OPD_CLASSES
+};
+
+OpdClass opdClass(TypeHandle type){
+	if (type.isInt()){ return OPD_INT; }
+	if (type.isBool()){ return OPD_BOOL; }
+	if (type.isError()){ return OPD_ERROR; }
+	return OPD_OTHER;
+}
+
+//An operator that takes operands of one class and whose
+// result has the type of its (left) operand. report is how a
+// bad operand is reported.
+struct OpSignature{
+	OpdClass operand;
+	void (TypeAnalysis::*report)(size_t line, size_t col);
+};
+
+//Indexed by opIndex, so in the order of NodeKind
+constexpr OpSignature OP_SIGNATURES[] = {
+	{OPD_INT, &TypeAnalysis::badMathOpd},   //PLUS
+	{OPD_INT, &TypeAnalysis::badMathOpd},   //MINUS
+	{OPD_INT, &TypeAnalysis::badMathOpd},   //TIMES
+	{OPD_INT, &TypeAnalysis::badMathOpd},   //DIVIDE
+	{OPD_BOOL, &TypeAnalysis::badLogicOpd}, //AND
+	{OPD_BOOL, &TypeAnalysis::badLogicOpd}, //OR
+	{OPD_OTHER, nullptr},                   //EQUALS, see checkEquality
+	{OPD_OTHER, nullptr},                   //NOT_EQUALS
+	{OPD_INT, &TypeAnalysis::badRelOpd},    //LESS
+	{OPD_INT, &TypeAnalysis::badRelOpd},    //LESS_EQ
+	{OPD_INT, &TypeAnalysis::badRelOpd},    //GREATER
+	{OPD_INT, &TypeAnalysis::badRelOpd},    //GREATER_EQ
+	{OPD_INT, &TypeAnalysis::badMathOpd},   //NEG
+	{OPD_BOOL, &TypeAnalysis::badLogicOpd}, //NOT
+};
+constexpr size_t OPS = sizeof(OP_SIGNATURES) / sizeof(OP_SIGNATURES[0]);
+static_assert(static_cast<size_t>(NodeKind::NOT)
+  - static_cast<size_t>(NodeKind::PLUS) + 1 == OPS,
+  "OP_SIGNATURES must cover PLUS through NOT");
+
+size_t opIndex(NodeKind kind){
+	return static_cast<size_t>(kind) - static_cast<size_t>(NodeKind::PLUS);
+}
+
+//The outcome of checking an operator: its result is its
+// operand's type, and/or which operands are reported
+enum : uint8_t { OP_OK = 1, OP_BAD_LHS = 2, OP_BAD_RHS = 4 };
+
+//The outcome for every operator and pair of operand classes
+struct OpTable{
+	constexpr OpTable() : myOutcomes(){
+		for (size_t op = 0; op < OPS; op++){
+			for (size_t lhs = 0; lhs < OPD_CLASSES; lhs++){
+				for (size_t rhs = 0; rhs < OPD_CLASSES; rhs++){
+					myOutcomes[op][lhs][rhs] = outcome(
+						OP_SIGNATURES[op].operand,
+						static_cast<OpdClass>(lhs),
+						static_cast<OpdClass>(rhs));
+				}
+			}
+		}
+	}
+	constexpr uint8_t get(size_t op, OpdClass lhs, OpdClass rhs) const {
+		return myOutcomes[op][lhs][rhs];
+	}
+private:
+	//An operand that is already an error has been reported, so
+	// the blame goes to the other one (even if it is fine)
+	static constexpr uint8_t outcome(OpdClass want,
+	  OpdClass lhs, OpdClass rhs){
+		return static_cast<uint8_t>(
+		  lhs == want && rhs == want ? OP_OK
+		  : lhs == OPD_ERROR && rhs == OPD_ERROR ? 0
+		  : lhs == OPD_ERROR ? OP_BAD_RHS
+		  : rhs == OPD_ERROR ? OP_BAD_LHS
+		  : (lhs != want ? OP_BAD_LHS : 0) | (rhs != want ? OP_BAD_RHS : 0));
+	}
+	uint8_t myOutcomes[OPS][OPD_CLASSES][OPD_CLASSES];
+};
+
+constexpr OpTable OP_OUTCOMES;
+
+//Checks the types of a tree, recording them in a TypeAnalysis
+class TypeChecker : public ASTVisitor<TypeChecker>{
+public:
+	TypeChecker(TypeAnalysis * taIn) : ta(taIn), retType(nullptr){ }
+
+	//Statements are checked knowing the return type of the
+	// function they are in, or nullptr outside one
+	void checkStmt(StmtNode * stmt, TypeNode * retTypeIn){
+		retType = retTypeIn;
+		visit(stmt);
+	}
+
+	void visitProgram(ProgramNode * node);
+	void visitFnDecl(FnDeclNode * node);
+	void visitDecl(DeclNode * node);
+	void visitVarDecl(VarDeclNode * node);
+
+	void visitStmt(StmtNode * node);
+	void visitAssignStmt(AssignStmtNode * node);
+	void visitPostDec(PostDecStmtNode * node);
+	void visitPostInc(PostIncStmtNode * node);
+	void visitFromConsole(FromConsoleStmtNode * node);
+	void visitToConsole(ToConsoleStmtNode * node);
+	void visitIf(IfStmtNode * node);
+	void visitIfElse(IfElseStmtNode * node);
+	void visitWhile(WhileStmtNode * node);
+	void visitReturn(ReturnStmtNode * node);
+	void visitCallStmt(CallStmtNode * node);
+
+	void visitExp(ExpNode * node);
+	void visitID(IDNode * node);
+	void visitRef(RefNode * node);
+	void visitDeref(DerefNode * node);
+	void visitIndex(IndexNode * node);
+	void visitCallExp(CallExpNode * node);
+	void visitAssignExp(AssignExpNode * node);
+	//Every operator but == and != is checked from OP_OUTCOMES
+	void visitBinaryExp(BinaryExpNode * node);
+	void visitUnaryExp(UnaryExpNode * node);
+	void visitEquals(EqualsNode * node){ checkEquality(node); }
+	void visitNotEquals(NotEqualsNode * node){ checkEquality(node); }
+	void visitIntLit(IntLitNode * node);
+	void visitStrLit(StrLitNode * node);
+	void visitCharLit(CharLitNode * node);
+	void visitTrue(TrueNode * node);
+	void visitFalse(FalseNode * node);
+private:
+	//Any two operands of the same type may be compared, which
+	// is more than an operand class can say
+	void checkEquality(BinaryExpNode * node);
+	//Whether two function-typed operands name the same function
+	bool sameFn(ExpNode * exp1, ExpNode * exp2){
+		if (exp1->kind() != NodeKind::ID || exp2->kind() != NodeKind::ID){
+			return false;
+		}
+		return ta->symbolOf(static_cast<IDNode *>(exp1))
+		  == ta->symbolOf(static_cast<IDNode *>(exp2));
+	}
+
+	TypeAnalysis * ta;
+	TypeNode * retType;
+};
+
+}
+
 TypeAnalysis * TypeAnalysis::build(NameAnalysis * nameAnalysis){
 	//To emphasize that type analysis depends on name analysis
 	// being complete, a name analysis must be supplied for 
 	// type analysis to be performed.
-	TypeAnalysis * typeAnalysis = new TypeAnalysis();
+	TypeAnalysis * typeAnalysis = new TypeAnalysis(
+		Arena::current()->nodeCount());
 	auto ast = nameAnalysis->ast;	
 	typeAnalysis->ast = ast;
+	typeAnalysis->symbols = &nameAnalysis->symbols;
 
 	ast->typeAnalysis(typeAnalysis);
 	if (typeAnalysis->hasError){
@@ -26,23 +180,27 @@ TypeAnalysis * TypeAnalysis::build(NameAnalysis * nameAnalysis){
 }
 
 void ProgramNode::typeAnalysis(TypeAnalysis * ta){
+	TypeChecker(ta).visit(this);
+}
+
+void TypeChecker::visitProgram(ProgramNode * node){
 
 	//pass the TypeAnalysis down throughout
 	// the entire tree, getting the types for
 	// each element in turn and adding them
 	// to the ta object's hashMap
-	for (auto global : *myGlobals){
-		global->typeAnalysis(ta,nullptr);
+	for (auto global : node->getGlobals()){
+		checkStmt(global, nullptr);
 	}
 
 	//The type of the program node will never
 	// be needed. We can just set it to VOID
 	//(Alternatively, we could make our type 
 	// be error if the DeclListNode is an error)
-	ta->nodeType(this, BasicType::produce(VOID));
+	ta->nodeType(node, TypeHandle::basic(VOID));
 }
 
-void FnDeclNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
+void TypeChecker::visitFnDecl(FnDeclNode * node){
 
 	//HINT: you might want to change the signature for
 	// typeAnalysis on FnBodyNode to take a second
@@ -55,84 +213,84 @@ void FnDeclNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
 
 	// loops through statement nodes
 	// call getRetTypeNode for fn return type and compare to any return statement nodes types
-	for (auto stmt : *myBody){
-		stmt->typeAnalysis(ta,myRetType);
+	for (auto stmt : node->getBody()){
+		checkStmt(stmt, node->getRetTypeNode());
 	}
 }
 
-void StmtNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
+void TypeChecker::visitStmt(StmtNode * node){
 	TODO("Implement me in the subclass");
 }
 
-void AssignStmtNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
-	myExp->typeAnalysis(ta);
+void TypeChecker::visitAssignStmt(AssignStmtNode * node){
+	visit(node->getExp());
 
 	//It can be a bit of a pain to write 
-	// "const DataType *" everywhere, so here
+	// "TypeHandle" everywhere, so here
 	// the use of auto is used instead to tell the
 	// compiler to figure out what the subType variable
 	// should be
-	auto subType = ta->nodeType(myExp);
+	auto subType = ta->nodeType(node->getExp());
 
 	// As error returns null if subType is NOT an error type
 	// otherwise, it returns the subType itself
 	// nullptr casts to boolean false
-	if (subType->asError()){
-		ta->nodeType(this, subType);
+	if (subType.isError()){
+		ta->nodeType(node, subType);
 	} else {
 		// if error occurs then set AssignStmtNode nodeType to VOID?
-		ta->nodeType(this, BasicType::produce(VOID));
+		ta->nodeType(node, TypeHandle::basic(VOID));
 	}
 }
 
-void ExpNode::typeAnalysis(TypeAnalysis * ta){
+void TypeChecker::visitExp(ExpNode * node){
 	//TODO("Override me in the subclass");
 }
 
-void AssignExpNode::typeAnalysis(TypeAnalysis * ta){
+void TypeChecker::visitAssignExp(AssignExpNode * node){
 	//TODO: Note that this function is incomplete. 
 	// and needs additional code
 
 	//Do typeAnalysis on the subexpressions
-	myDst->typeAnalysis(ta);
-	mySrc->typeAnalysis(ta);
+	visit(node->getDst());
+	visit(node->getSrc());
 
-	const DataType * tgtType = ta->nodeType(myDst);
-	const DataType * srcType = ta->nodeType(mySrc);
+	TypeHandle tgtType = ta->nodeType(node->getDst());
+	TypeHandle srcType = ta->nodeType(node->getSrc());
 
 	//While incomplete, this gives you one case for 
 	// assignment: if the types are exactly the same
 	// it is usually ok to do the assignment. One
 	// exception is that if both types are function
 	// names, it should fail type analysis
-	if(tgtType->asFn()!=nullptr || srcType->asFn()!=nullptr){
-	    if(tgtType->asFn()!=nullptr && srcType->asFn()!=nullptr){
-		ta->badAssignOpd(myDst->line(), myDst->col());
-		ta->badAssignOpd(mySrc->line(), mySrc->col());
-		ta->nodeType(this, ErrorType::produce());
+	if(tgtType.isFn() || srcType.isFn()){
+	    if(tgtType.isFn() && srcType.isFn()){
+		ta->badAssignOpd(node->getDst()->line(), node->getDst()->col());
+		ta->badAssignOpd(node->getSrc()->line(), node->getSrc()->col());
+		ta->nodeType(node, TypeHandle::error());
 	    }
-	    else if( tgtType->asFn()!=nullptr ){
-		ta->badAssignOpd(myDst->line(), myDst->col());
-		ta->nodeType(this, ErrorType::produce());
+	    else if( tgtType.isFn() ){
+		ta->badAssignOpd(node->getDst()->line(), node->getDst()->col());
+		ta->nodeType(node, TypeHandle::error());
 	    }
 	    else{
-		ta->badAssignOpd(mySrc->line(), mySrc->col());
-		ta->nodeType(this, ErrorType::produce());
+		ta->badAssignOpd(node->getSrc()->line(), node->getSrc()->col());
+		ta->nodeType(node, TypeHandle::error());
 	    }
 	    return;
 	}
 	if (tgtType == srcType){
-		if (tgtType->validVarType() == false) { //call false for void and fn types
+		if (tgtType.validVarType() == false) { //call false for void and fn types
 			//call error
 		}
 		else {
-			ta->nodeType(this, tgtType);
+			ta->nodeType(node, tgtType);
 		}
 		return;
 	}
 	// TODO will need to adapt this later but for now set AssignExpNode node to to error and don't report if tgtType or srcType is error
-	if(tgtType->asError()!=nullptr || srcType->asError()!=nullptr ){
-	    ta->nodeType(this, ErrorType::produce());
+	if(tgtType.isError() || srcType.isError() ){
+	    ta->nodeType(node, TypeHandle::error());
 	    return;
 	}
 	
@@ -141,635 +299,148 @@ void AssignExpNode::typeAnalysis(TypeAnalysis * ta){
 	// also tell the typeAnalysis object that the
 	// analysis has failed, meaning that main.cpp
 	// will print "Type check failed" at the end
-	ta->badAssignOpr(this->line(), this->col());
+	ta->badAssignOpr(node->line(), node->col());
 
 	//Note that reporting an error does not set the
 	// type of the current node, so setting the node
 	// type must be done
-	ta->nodeType(this, ErrorType::produce());
+	ta->nodeType(node, TypeHandle::error());
 }
 
-void DeclNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
+void TypeChecker::visitDecl(DeclNode * node){
 	//TODO("Override me in the subclass");
 }
 
-void VarDeclNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
+void TypeChecker::visitVarDecl(VarDeclNode * node){
 	// VarDecls always pass type analysis, since they 
 	// are never used in an expression. You may choose
 	// to type them void (like this), as discussed in class
-	ta->nodeType(this, BasicType::produce(VOID));
+	ta->nodeType(node, TypeHandle::basic(VOID));
 }
 
-void IDNode::typeAnalysis(TypeAnalysis * ta){
+void TypeChecker::visitID(IDNode * node){
 	// IDs never fail type analysis and always
 	// yield the type of their symbol (which
 	// depends on their definition)
-	ta->nodeType(this, this->getSymbol()->getDataType());
+	ta->nodeType(node, ta->symbolOf(node)->getDataType()->handle());
 }
 
-void IntLitNode::typeAnalysis(TypeAnalysis * ta){
+void TypeChecker::visitIntLit(IntLitNode * node){
 	// IntLits never fail their type analysis and always
 	// yield the type INT
-	ta->nodeType(this, BasicType::produce(INT));
-}
-
-void CharLitNode::typeAnalysis(TypeAnalysis * ta){
-	ta->nodeType(this, BasicType::produce(CHAR));
-}
-
-void FalseNode::typeAnalysis(TypeAnalysis * ta){
-	ta->nodeType(this, BasicType::produce(BOOL));
-}
-
-void TrueNode::typeAnalysis(TypeAnalysis * ta){
-	ta->nodeType(this, BasicType::produce(BOOL));
+	ta->nodeType(node, TypeHandle::basic(INT));
 }
 
-void StrLitNode::typeAnalysis(TypeAnalysis * ta){
-    ta->nodeType(this, PtrType::produce(BasicType::produce(CHAR),1));
+void TypeChecker::visitCharLit(CharLitNode * node){
+	ta->nodeType(node, TypeHandle::basic(CHAR));
 }
 
-void DivideNode::typeAnalysis(TypeAnalysis * ta){
-	//Do typeAnalysis on the subexpressions
-	myExp1->typeAnalysis(ta);
-	myExp2->typeAnalysis(ta);
-
-	// constant containing the type returned from type analysis on both expressions
-	const DataType * exp1 = ta->nodeType(myExp1);
-	const DataType * exp2 = ta->nodeType(myExp2);
-
-	// base case is you dont throw an error if the types are compatible for division i.e. both are integers 
-	// checks that both expression types are the same and both are int type
-	if (exp1 == exp2 && exp1->isInt()){
-		ta->nodeType(this, exp1);
-	}
-	// case where exp1 & exp2 are errors
-	else if(exp1->asError()!=nullptr && exp2->asError()!=nullptr ){
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp1 is an error
-	else if(exp1->asError()!=nullptr && exp2->asError()==nullptr ){
-	    ta->badMathOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp2 is an error
-	else if(exp1->asError()==nullptr && exp2->asError()!=nullptr ){
-	    ta->badMathOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-
-	// if both are not int throw Arithmetic operator applied to incompatible operands
-	else if(!exp1->isInt() && !exp2->isInt()){
-	    ta->badMathOpd(myExp1->line(), myExp1->col());
-	    ta->badMathOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// first expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(!exp1->isInt() && exp2->isInt() ){
-	    ta->badMathOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// second expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(exp1->isInt() && !exp2->isInt()){
-	    ta->badMathOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-}
-
-void TimesNode::typeAnalysis(TypeAnalysis * ta){
-	//Do typeAnalysis on the subexpressions
-	myExp1->typeAnalysis(ta);
-	myExp2->typeAnalysis(ta);
-
-	// constant containing the type returned from type analysis on both expressions
-	const DataType * exp1 = ta->nodeType(myExp1);
-	const DataType * exp2 = ta->nodeType(myExp2);
-
-	// base case is you dont throw an error if the types are compatible for multiplication i.e. both are integers 
-	// checks that both expression types are the same and both are int type
-	if (exp1 == exp2 && exp1->isInt()){
-		ta->nodeType(this, exp1);
-	}
-	// case where exp1 & exp2 are errors
-	else if(exp1->asError()!=nullptr && exp2->asError()!=nullptr ){
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp1 is an error
-	else if(exp1->asError()!=nullptr && exp2->asError()==nullptr ){
-	    ta->badMathOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp2 is an error
-	else if(exp1->asError()==nullptr && exp2->asError()!=nullptr ){
-	    ta->badMathOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-
-	// if both are not int throw Arithmetic operator applied to incompatible operands
-	else if(!exp1->isInt() && !exp2->isInt()){
-	    ta->badMathOpd(myExp1->line(), myExp1->col());
-	    ta->badMathOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// first expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(!exp1->isInt() && exp2->isInt() ){
-	    ta->badMathOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// second expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(exp1->isInt() && !exp2->isInt()){
-	    ta->badMathOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-}
-
-void MinusNode::typeAnalysis(TypeAnalysis * ta){
-	//Do typeAnalysis on the subexpressions
-	myExp1->typeAnalysis(ta);
-	myExp2->typeAnalysis(ta);
-
-	// constant containing the type returned from type analysis on both expressions
-	const DataType * exp1 = ta->nodeType(myExp1);
-	const DataType * exp2 = ta->nodeType(myExp2);
-
-	// base case is you dont throw an error if the types are compatible for subtraction i.e. both are integers 
-	// checks that both expression types are the same and both are int type
-	if (exp1 == exp2 && exp1->isInt()){
-		ta->nodeType(this, exp1);
-	}
-	// case where exp1 & exp2 are errors
-	else if(exp1->asError()!=nullptr && exp2->asError()!=nullptr ){
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp1 is an error
-	else if(exp1->asError()!=nullptr && exp2->asError()==nullptr ){
-	    ta->badMathOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp2 is an error
-	else if(exp1->asError()==nullptr && exp2->asError()!=nullptr ){
-	    ta->badMathOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-
-	// if both are not int throw Arithmetic operator applied to incompatible operands
-	else if(!exp1->isInt() && !exp2->isInt()){
-	    ta->badMathOpd(myExp1->line(), myExp1->col());
-	    ta->badMathOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// first expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(!exp1->isInt() && exp2->isInt() ){
-	    ta->badMathOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// second expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(exp1->isInt() && !exp2->isInt()){
-	    ta->badMathOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
+void TypeChecker::visitFalse(FalseNode * node){
+	ta->nodeType(node, TypeHandle::basic(BOOL));
 }
 
-void PlusNode::typeAnalysis(TypeAnalysis * ta){
-	//Do typeAnalysis on the subexpressions
-	myExp1->typeAnalysis(ta);
-	myExp2->typeAnalysis(ta);
-
-	// constant containing the type returned from type analysis on both expressions
-	const DataType * exp1 = ta->nodeType(myExp1);
-	const DataType * exp2 = ta->nodeType(myExp2);
-
-	// base case is you dont throw an error if the types are compatible for addition i.e. both are integers 
-	// checks that both expression types are the same and both are int type
-	if (exp1 == exp2 && exp1->isInt()){
-		ta->nodeType(this, exp1);
-	}
-	// case where exp1 & exp2 are errors
-	else if(exp1->asError()!=nullptr && exp2->asError()!=nullptr ){
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp1 is an error
-	else if(exp1->asError()!=nullptr && exp2->asError()==nullptr ){
-	    ta->badMathOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp2 is an error
-	else if(exp1->asError()==nullptr && exp2->asError()!=nullptr ){
-	    ta->badMathOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-
-	// if both are not int throw Arithmetic operator applied to incompatible operands
-	else if(!exp1->isInt() && !exp2->isInt()){
-	    ta->badMathOpd(myExp1->line(), myExp1->col());
-	    ta->badMathOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// first expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(!exp1->isInt() && exp2->isInt() ){
-	    ta->badMathOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// second expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(exp1->isInt() && !exp2->isInt()){
-	    ta->badMathOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
+void TypeChecker::visitTrue(TrueNode * node){
+	ta->nodeType(node, TypeHandle::basic(BOOL));
 }
 
-void NegNode::typeAnalysis(TypeAnalysis * ta){
-	myExp->typeAnalysis(ta);
-
-	const DataType * exp1 = ta->nodeType(myExp);
-
-	// base case is you dont throw an error if the type is an int 
-	if (exp1->isInt()){
-		ta->nodeType(this, exp1);
-	}
-	// case where exp1 is an error
-	else if(exp1->asError()){
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where not an int and not an error
-	else{
-	    ta->badMathOpd(myExp->line(), myExp->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
+void TypeChecker::visitStrLit(StrLitNode * node){
+    ta->nodeType(node, TypeHandle::ptr(CHAR, 1));
 }
 
-void PostDecStmtNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
-	myLVal->typeAnalysis(ta);
+void TypeChecker::visitPostDec(PostDecStmtNode * node){
+	visit(node->getLVal());
 
-	const DataType * lval = ta->nodeType(myLVal);
+	TypeHandle lval = ta->nodeType(node->getLVal());
 
 	// base case is you dont throw an error if the type is an int 
-	if (lval->isInt()){
-		ta->nodeType(this, lval);
+	if (lval.isInt()){
+		ta->nodeType(node, lval);
 	}
 	// expression is a pointer
-	else if (lval->isPtr()){
-	    ta->badMathOpr(this->line(),this->col());
-	    ta->nodeType(this, ErrorType::produce());
+	else if (lval.isPtr()){
+	    ta->badMathOpr(node->line(),node->col());
+	    ta->nodeType(node, TypeHandle::error());
 	}
 	// case where lval is an error
-	else if(lval->asError()!=nullptr){
-	    ta->nodeType(this, ErrorType::produce());
+	else if(lval.isError()){
+	    ta->nodeType(node, TypeHandle::error());
 	}
 	// case where not an int and not an error
 	else{
-	    ta->badMathOpd(myLVal->line(), myLVal->col());
-	    ta->nodeType(this, ErrorType::produce());
+	    ta->badMathOpd(node->getLVal()->line(), node->getLVal()->col());
+	    ta->nodeType(node, TypeHandle::error());
 	}
 }
 
-void PostIncStmtNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
-	myLVal->typeAnalysis(ta);
+void TypeChecker::visitPostInc(PostIncStmtNode * node){
+	visit(node->getLVal());
 
-	const DataType * lval = ta->nodeType(myLVal);
+	TypeHandle lval = ta->nodeType(node->getLVal());
 
 	// base case is you dont throw an error if the type is an int 
-	if (lval->isInt()){
-		ta->nodeType(this, lval);
+	if (lval.isInt()){
+		ta->nodeType(node, lval);
 	}
 	// expression is a pointer
-	else if (lval->isPtr()){
-	    ta->badMathOpr(this->line(),this->col());
-	    ta->nodeType(this, ErrorType::produce());
+	else if (lval.isPtr()){
+	    ta->badMathOpr(node->line(),node->col());
+	    ta->nodeType(node, TypeHandle::error());
 	}
 	// case where lval is an error
-	else if(lval->asError()!=nullptr){
-	    ta->nodeType(this, ErrorType::produce());
+	else if(lval.isError()){
+	    ta->nodeType(node, TypeHandle::error());
 	}
 	// case where not an int and not an error
 	else{
-	    ta->badMathOpd(myLVal->line(), myLVal->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-}
-
-void GreaterEqNode::typeAnalysis(TypeAnalysis * ta){
-	//Do typeAnalysis on the subexpressions
-	myExp1->typeAnalysis(ta);
-	myExp2->typeAnalysis(ta);
-
-	// constant containing the type returned from type analysis on both expressions
-	const DataType * exp1 = ta->nodeType(myExp1);
-	const DataType * exp2 = ta->nodeType(myExp2);
-
-	// base case is you dont throw an error if the types are compatible for relation operator i.e. both are integers 
-	// checks that both expression types are the same and both are int type
-	if (exp1 == exp2 && exp1->isInt()){
-		ta->nodeType(this, exp1);
-	}
-	// case where exp1 & exp2 are errors
-	else if(exp1->asError()!=nullptr && exp2->asError()!=nullptr ){
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp1 is an error
-	else if(exp1->asError()!=nullptr && exp2->asError()==nullptr ){
-	    ta->badRelOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp2 is an error
-	else if(exp1->asError()==nullptr && exp2->asError()!=nullptr ){
-	    ta->badRelOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-
-	// if both are not int throw Arithmetic operator applied to incompatible operands
-	else if(!exp1->isInt() && !exp2->isInt()){
-	    ta->badRelOpd(myExp1->line(), myExp1->col());
-	    ta->badRelOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// first expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(!exp1->isInt() && exp2->isInt() ){
-	    ta->badRelOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// second expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(exp1->isInt() && !exp2->isInt()){
-	    ta->badRelOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-}
-
-void GreaterNode::typeAnalysis(TypeAnalysis * ta){
-	//Do typeAnalysis on the subexpressions
-	myExp1->typeAnalysis(ta);
-	myExp2->typeAnalysis(ta);
-
-	// constant containing the type returned from type analysis on both expressions
-	const DataType * exp1 = ta->nodeType(myExp1);
-	const DataType * exp2 = ta->nodeType(myExp2);
-
-	// base case is you dont throw an error if the types are compatible for relation operator i.e. both are integers 
-	// checks that both expression types are the same and both are int type
-	if (exp1 == exp2 && exp1->isInt()){
-		ta->nodeType(this, exp1);
-	}
-	// case where exp1 & exp2 are errors
-	else if(exp1->asError()!=nullptr && exp2->asError()!=nullptr ){
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp1 is an error
-	else if(exp1->asError()!=nullptr && exp2->asError()==nullptr ){
-	    ta->badRelOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp2 is an error
-	else if(exp1->asError()==nullptr && exp2->asError()!=nullptr ){
-	    ta->badRelOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-
-	// if both are not int throw Arithmetic operator applied to incompatible operands
-	else if(!exp1->isInt() && !exp2->isInt()){
-	    ta->badRelOpd(myExp1->line(), myExp1->col());
-	    ta->badRelOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// first expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(!exp1->isInt() && exp2->isInt() ){
-	    ta->badRelOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// second expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(exp1->isInt() && !exp2->isInt()){
-	    ta->badRelOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-}
-
-void LessEqNode::typeAnalysis(TypeAnalysis * ta){
-	//Do typeAnalysis on the subexpressions
-	myExp1->typeAnalysis(ta);
-	myExp2->typeAnalysis(ta);
-
-	// constant containing the type returned from type analysis on both expressions
-	const DataType * exp1 = ta->nodeType(myExp1);
-	const DataType * exp2 = ta->nodeType(myExp2);
-
-	// base case is you dont throw an error if the types are compatible for relation operator i.e. both are integers 
-	// checks that both expression types are the same and both are int type
-	if (exp1 == exp2 && exp1->isInt()){
-		ta->nodeType(this, exp1);
-	}
-	// case where exp1 & exp2 are errors
-	else if(exp1->asError()!=nullptr && exp2->asError()!=nullptr ){
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp1 is an error
-	else if(exp1->asError()!=nullptr && exp2->asError()==nullptr ){
-	    ta->badRelOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp2 is an error
-	else if(exp1->asError()==nullptr && exp2->asError()!=nullptr ){
-	    ta->badRelOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-
-	// if both are not int throw Arithmetic operator applied to incompatible operands
-	else if(!exp1->isInt() && !exp2->isInt()){
-	    ta->badRelOpd(myExp1->line(), myExp1->col());
-	    ta->badRelOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// first expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(!exp1->isInt() && exp2->isInt() ){
-	    ta->badRelOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// second expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(exp1->isInt() && !exp2->isInt()){
-	    ta->badRelOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
+	    ta->badMathOpd(node->getLVal()->line(), node->getLVal()->col());
+	    ta->nodeType(node, TypeHandle::error());
 	}
 }
 
-void LessNode::typeAnalysis(TypeAnalysis * ta){
+void TypeChecker::visitBinaryExp(BinaryExpNode * node){
 	//Do typeAnalysis on the subexpressions
-	myExp1->typeAnalysis(ta);
-	myExp2->typeAnalysis(ta);
+	visit(node->getExp1());
+	visit(node->getExp2());
 
-	// constant containing the type returned from type analysis on both expressions
-	const DataType * exp1 = ta->nodeType(myExp1);
-	const DataType * exp2 = ta->nodeType(myExp2);
-
-	// base case is you dont throw an error if the types are compatible for relation operator i.e. both are integers 
-	// checks that both expression types are the same and both are int type
-	if (exp1 == exp2 && exp1->isInt()){
-		ta->nodeType(this, exp1);
-	}
-	// case where exp1 & exp2 are errors
-	else if(exp1->asError()!=nullptr && exp2->asError()!=nullptr ){
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp1 is an error
-	else if(exp1->asError()!=nullptr && exp2->asError()==nullptr ){
-	    ta->badRelOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp2 is an error
-	else if(exp1->asError()==nullptr && exp2->asError()!=nullptr ){
-	    ta->badRelOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-
-	// if both are not int throw Arithmetic operator applied to incompatible operands
-	else if(!exp1->isInt() && !exp2->isInt()){
-	    ta->badRelOpd(myExp1->line(), myExp1->col());
-	    ta->badRelOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// first expression is not an int
-	// throw Arithmetic operator applied to invalid operand
-	else if(!exp1->isInt() && exp2->isInt() ){
-	    ta->badRelOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// second expression is not an int
-	else if(exp1->isInt() && !exp2->isInt()){
-	    ta->badRelOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-}
-
-void OrNode::typeAnalysis(TypeAnalysis * ta){
-	//Do typeAnalysis on the subexpressions
-	myExp1->typeAnalysis(ta);
-	myExp2->typeAnalysis(ta);
-
-	// constant containing the type returned from type analysis on both expressions
-	const DataType * exp1 = ta->nodeType(myExp1);
-	const DataType * exp2 = ta->nodeType(myExp2);
-
-	// base case is you dont throw an error if the types are compatible for logical operator i.e. both are bool 
-	// checks that both expression types are the same and both are bool type
-	if (exp1 == exp2 && exp1->isBool()){
-	    ta->nodeType(this, exp1);
-	}
-	// case where exp1 & exp2 are errors
-	else if(exp1->asError()!=nullptr && exp2->asError()!=nullptr ){
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp1 is an error
-	else if(exp1->asError()!=nullptr && exp2->asError()==nullptr ){
-	    ta->badLogicOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp2 is an error
-	else if(exp1->asError()==nullptr && exp2->asError()!=nullptr ){
-	    ta->badLogicOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-
-	else if(!exp1->isBool() && !exp2->isBool()){
-	    ta->badLogicOpd(myExp1->line(), myExp1->col());
-	    ta->badLogicOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// first expression is not an bool
-	else if(!exp1->isBool() && exp2->isBool() ){
-	    ta->badLogicOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// second expression is not an bool
-	else if(exp1->isBool() && !exp2->isBool()){
-	    ta->badLogicOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-}
-
-void AndNode::typeAnalysis(TypeAnalysis * ta){
-	//Do typeAnalysis on the subexpressions
-	myExp1->typeAnalysis(ta);
-	myExp2->typeAnalysis(ta);
-
-	// constant containing the type returned from type analysis on both expressions
-	const DataType * exp1 = ta->nodeType(myExp1);
-	const DataType * exp2 = ta->nodeType(myExp2);
-
-	// base case is you dont throw an error if the types are compatible for logical operator i.e. both are bool 
-	// checks that both expression types are the same and both are bool type
-	if (exp1 == exp2 && exp1->isBool()){
-		ta->nodeType(this, exp1);
-	}
-	// case where exp1 & exp2 are errors
-	else if(exp1->asError()!=nullptr && exp2->asError()!=nullptr ){
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp1 is an error
-	else if(exp1->asError()!=nullptr && exp2->asError()==nullptr ){
-	    ta->badLogicOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where exp2 is an error
-	else if(exp1->asError()==nullptr && exp2->asError()!=nullptr ){
-	    ta->badLogicOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
+	TypeHandle exp1 = ta->nodeType(node->getExp1());
+	TypeHandle exp2 = ta->nodeType(node->getExp2());
 
-	else if(!exp1->isBool() && !exp2->isBool()){
-	    ta->badLogicOpd(myExp1->line(), myExp1->col());
-	    ta->badLogicOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
+	size_t op = opIndex(node->kind());
+	uint8_t outcome = OP_OUTCOMES.get(op, opdClass(exp1), opdClass(exp2));
+	auto report = OP_SIGNATURES[op].report;
+	if (outcome & OP_BAD_LHS){
+	    (ta->*report)(node->getExp1()->line(), node->getExp1()->col());
 	}
-	// first expression is not an bool
-	else if(!exp1->isBool() && exp2->isBool() ){
-	    ta->badLogicOpd(myExp1->line(), myExp1->col());
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// second expression is not an bool
-	else if(exp1->isBool() && !exp2->isBool()){
-	    ta->badLogicOpd(myExp2->line(), myExp2->col());
-	    ta->nodeType(this, ErrorType::produce());
+	if (outcome & OP_BAD_RHS){
+	    (ta->*report)(node->getExp2()->line(), node->getExp2()->col());
 	}
+	ta->nodeType(node, (outcome & OP_OK) ? exp1 : TypeHandle::error());
 }
 
-void NotNode::typeAnalysis(TypeAnalysis * ta){
-	myExp->typeAnalysis(ta);
+void TypeChecker::visitUnaryExp(UnaryExpNode * node){
+	visit(node->getExp());
 
-	const DataType * exp1 = ta->nodeType(myExp);
+	TypeHandle exp = ta->nodeType(node->getExp());
 
-	// base case is you dont throw an error if the type is an bool 
-	if (exp1->isBool()){
-		ta->nodeType(this, exp1);
-	}
-	// case where exp1 is an error
-	else if(exp1->asError()!=nullptr){
-	    ta->nodeType(this, ErrorType::produce());
-	}
-	// case where not an bool and not an error
-	else{
-	    ta->badLogicOpd(myExp->line(), myExp->col());
-	    ta->nodeType(this, ErrorType::produce());
+	//Checked as if both operands of a binary operator were exp
+	OpdClass cls = opdClass(exp);
+	size_t op = opIndex(node->kind());
+	uint8_t outcome = OP_OUTCOMES.get(op, cls, cls);
+	if (outcome & OP_BAD_LHS){
+	    auto report = OP_SIGNATURES[op].report;
+	    (ta->*report)(node->getExp()->line(), node->getExp()->col());
 	}
+	ta->nodeType(node, (outcome & OP_OK) ? exp : TypeHandle::error());
 }
 
-void EqualsNode::typeAnalysis(TypeAnalysis * ta){
+void TypeChecker::checkEquality(BinaryExpNode * node){
 	//Do typeAnalysis on the subexpressions
-	myExp1->typeAnalysis(ta);
-	myExp2->typeAnalysis(ta);
+	visit(node->getExp1());
+	visit(node->getExp2());
 
 	// constant containing the type returned from type analysis on both expressions
-	const DataType * exp1 = ta->nodeType(myExp1);
-	const DataType * exp2 = ta->nodeType(myExp2);
+	TypeHandle exp1 = ta->nodeType(node->getExp1());
+	TypeHandle exp2 = ta->nodeType(node->getExp2());
 
 	bool doReturn1 = false;
 	bool doReturn2 = false;
@@ -778,379 +449,310 @@ void EqualsNode::typeAnalysis(TypeAnalysis * ta){
 	// checks that both expression types are the same 
 	// TODO check to make sure that type is not a function name or of type void
 	// case where exp1 & exp2 are errors
-	if(exp1->asError()!=nullptr && exp2->asError()!=nullptr ){
-	    ta->nodeType(this, ErrorType::produce());
+	if(exp1.isError() && exp2.isError() ){
+	    ta->nodeType(node, TypeHandle::error());
 	    return;
 	}
 	// case where exp1 is an error
-	if(exp1->asError()!=nullptr && exp2->asError()==nullptr ){
-	    ta->badEqOpr(this->line(), this->col());
-	    ta->nodeType(this, ErrorType::produce());
+	if(exp1.isError() && !exp2.isError() ){
+	    ta->badEqOpr(node->line(), node->col());
+	    ta->nodeType(node, TypeHandle::error());
 	    return;
 	}
 	// case where exp2 is an error
-	if(exp1->asError()==nullptr && exp2->asError()!=nullptr ){
-	    ta->badEqOpr(this->line(), this->col());
-	    ta->nodeType(this, ErrorType::produce());
+	if(!exp1.isError() && exp2.isError() ){
+	    ta->badEqOpr(node->line(), node->col());
+	    ta->nodeType(node, TypeHandle::error());
 	    return;
 	}
-	if(exp1->asFn()!=nullptr || exp2->asFn()!=nullptr || exp1->isVoid() || exp2->isVoid()){
-	    if( exp1->asFn()!=nullptr ){
-	    if(exp1->asFn()->getFormalTypes()->size()-2==0 ){
+	if(exp1.isFn() || exp2.isFn() || exp1.isVoid() || exp2.isVoid()){
+	    if( exp1.isFn() ){
+	    if(exp1.asFn()->getFormalTypes()->size()-2==0 ){
 		doReturn1 = true;
-		ta->badEqOpd(myExp1->line(), myExp1->col());
+		ta->badEqOpd(node->getExp1()->line(), node->getExp1()->col());
 	    }
 	    }
-	    if( exp2->asFn()!=nullptr ){
-	    if(exp2->asFn()->getFormalTypes()->size()-2==0 ){
+	    if( exp2.isFn() ){
+	    if(exp2.asFn()->getFormalTypes()->size()-2==0 ){
 		doReturn2 = true;
-		ta->badEqOpd(myExp2->line(), myExp2->col());
+		ta->badEqOpd(node->getExp2()->line(), node->getExp2()->col());
 	    }
 	    }
-	    if(exp1->isVoid()){
+	    if(exp1.isVoid()){
 		doReturn1 = true;
-		ta->badEqOpd(myExp1->line(), myExp1->col());
+		ta->badEqOpd(node->getExp1()->line(), node->getExp1()->col());
 	    }
-	    if( exp2->isVoid()){
+	    if( exp2.isVoid()){
 		doReturn1 = true;
-		ta->badEqOpd(myExp2->line(), myExp2->col());
+		ta->badEqOpd(node->getExp2()->line(), node->getExp2()->col());
 	    }
 	    if(doReturn1 || doReturn2){
-		ta->nodeType(this, ErrorType::produce());
+		ta->nodeType(node, TypeHandle::error());
 		return;
 	    }
 	}
-	if (exp1 == exp2){
-	    ta->nodeType(this, exp1);
-	    return;
-	}
-	// if both are not the same type throw error
-	if(exp1 != exp2){
-	    ta->badEqOpr(this->line(), this->col());
-	    ta->nodeType(this, ErrorType::produce());
+	// functions with the same signature share a FnType, but two
+	// different functions are still not equal
+	if(exp1.isFn() && exp2.isFn()
+	  && !sameFn(node->getExp1(), node->getExp2())){
+	    ta->badEqOpr(node->line(), node->col());
+	    ta->nodeType(node, TypeHandle::error());
 	    return;
 	}
-}
-
-void NotEqualsNode::typeAnalysis(TypeAnalysis * ta){
-
-	//Do typeAnalysis on the subexpressions
-	myExp1->typeAnalysis(ta);
-	myExp2->typeAnalysis(ta);
-
-	// constant containing the type returned from type analysis on both expressions
-	const DataType * exp1 = ta->nodeType(myExp1);
-	const DataType * exp2 = ta->nodeType(myExp2);
-
-	bool doReturn1 = false;
-	bool doReturn2 = false;
-
-	// base case is you dont throw an error if the types are compatible for equality operator i.e. both are same type 
-	// checks that both expression types are the same 
-	// TODO check to make sure that type is not a function name or of type void
-	// case where exp1 & exp2 are errors
-	if(exp1->asError()!=nullptr && exp2->asError()!=nullptr ){
-	    ta->nodeType(this, ErrorType::produce());
-	    return;
-	}
-	// case where exp1 is an error
-	if(exp1->asError()!=nullptr && exp2->asError()==nullptr ){
-	    ta->badEqOpr(this->line(), this->col());
-	    ta->nodeType(this, ErrorType::produce());
-	    return;
-	}
-	// case where exp2 is an error
-	if(exp1->asError()==nullptr && exp2->asError()!=nullptr ){
-	    ta->badEqOpr(this->line(), this->col());
-	    ta->nodeType(this, ErrorType::produce());
-	    return;
-	}
-	if(exp1->asFn()!=nullptr || exp2->asFn()!=nullptr || exp1->isVoid() || exp2->isVoid()){
-	    if( exp1->asFn()!=nullptr ){
-	    if(exp1->asFn()->getFormalTypes()->size()-2==0 ){
-		doReturn1 = true;
-		ta->badEqOpd(myExp1->line(), myExp1->col());
-	    }
-	    }
-	    if( exp2->asFn()!=nullptr ){
-	    if(exp2->asFn()->getFormalTypes()->size()-2==0 ){
-		doReturn2 = true;
-		ta->badEqOpd(myExp2->line(), myExp2->col());
-	    }
-	    }
-	    if(exp1->isVoid()){
-		doReturn1 = true;
-		ta->badEqOpd(myExp1->line(), myExp1->col());
-	    }
-	    if( exp2->isVoid()){
-		doReturn1 = true;
-		ta->badEqOpd(myExp2->line(), myExp2->col());
-	    }
-	    if(doReturn1 || doReturn2){
-		ta->nodeType(this, ErrorType::produce());
-		return;
-	    }
-	}
 	if (exp1 == exp2){
-	    ta->nodeType(this, exp1);
+	    ta->nodeType(node, exp1);
 	    return;
 	}
 	// if both are not the same type throw error
 	if(exp1 != exp2){
-	    ta->badEqOpr(this->line(), this->col());
-	    ta->nodeType(this, ErrorType::produce());
+	    ta->badEqOpr(node->line(), node->col());
+	    ta->nodeType(node, TypeHandle::error());
 	    return;
 	}
-
 }
 
-void WhileStmtNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
+void TypeChecker::visitWhile(WhileStmtNode * node){
     // call type Analysis on the condition and on each stmt in the body
 	// recursivvely call type analysis on list of StmtNode in the body
 	//Do typeAnalysis on the condition
-	myCond->typeAnalysis(ta);
+	visit(node->getCond());
 
 	// constant containing the type returned from type analysis on condition
-	const DataType * cond = ta->nodeType(myCond);
+	TypeHandle cond = ta->nodeType(node->getCond());
 
-	if (cond->isBool()){
-	    ta->nodeType(this, cond);
+	if (cond.isBool()){
+	    ta->nodeType(node, cond);
 	}
 	// case where cond is an error
-	else if(cond->asError()!=nullptr){
-	    ta->nodeType(this, ErrorType::produce());
+	else if(cond.isError()){
+	    ta->nodeType(node, TypeHandle::error());
 	}
 	// cond is not a bool and not an error type
 	else{
-	    ta->badWhileCond(myCond->line(), myCond->col());
-	    ta->nodeType(this, ErrorType::produce());
+	    ta->badWhileCond(node->getCond()->line(), node->getCond()->col());
+	    ta->nodeType(node, TypeHandle::error());
 	}
 
-	for(auto stmt: *myBody){
-	    stmt->typeAnalysis(ta, nullptr);
+	for(auto stmt: node->getBody()){
+	    checkStmt(stmt, nullptr);
 	}
 }
 
-void IfStmtNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
+void TypeChecker::visitIf(IfStmtNode * node){
     // call type Analysis on the condition and on each stmt in the body
 	// recursivvely call type analysis on list of StmtNode in the body
 	//Do typeAnalysis on the condition
-	myCond->typeAnalysis(ta);
+	visit(node->getCond());
 
 	// constant containing the type returned from type analysis on condition
-	const DataType * cond = ta->nodeType(myCond);
+	TypeHandle cond = ta->nodeType(node->getCond());
 
-	if (cond->isBool()){
-	    ta->nodeType(this, cond);
+	if (cond.isBool()){
+	    ta->nodeType(node, cond);
 	}
 	// case where cond is an error
-	else if(cond->asError()!=nullptr){
-	    ta->nodeType(this, ErrorType::produce());
+	else if(cond.isError()){
+	    ta->nodeType(node, TypeHandle::error());
 	}
 	// cond is not a bool and not an error type
 	else{
-	    ta->badIfCond(myCond->line(), myCond->col());
-	    ta->nodeType(this, ErrorType::produce());
+	    ta->badIfCond(node->getCond()->line(), node->getCond()->col());
+	    ta->nodeType(node, TypeHandle::error());
 	}
 
-	for(auto stmt: *myBody){
-	    stmt->typeAnalysis(ta, nullptr);
+	for(auto stmt: node->getBody()){
+	    checkStmt(stmt, nullptr);
 	}
 }
 
-void IfElseStmtNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
+void TypeChecker::visitIfElse(IfElseStmtNode * node){
     // call type Analysis on the condition and on each stmt in the body
 	// recursivvely call type analysis on list of StmtNode in the body
 	//Do typeAnalysis on the condition
-	myCond->typeAnalysis(ta);
+	visit(node->getCond());
 
 	// constant containing the type returned from type analysis on condition
-	const DataType * cond = ta->nodeType(myCond);
+	TypeHandle cond = ta->nodeType(node->getCond());
 
-	if (cond->isBool()){
-	    ta->nodeType(this, cond);
+	if (cond.isBool()){
+	    ta->nodeType(node, cond);
 	}
 	// case where cond is an error
-	else if(cond->asError()!=nullptr){
-	    ta->nodeType(this, ErrorType::produce());
+	else if(cond.isError()){
+	    ta->nodeType(node, TypeHandle::error());
 	}
 	// cond is not a bool and not an error type
 	else{
-	    ta->badIfCond(myCond->line(), myCond->col());
-	    ta->nodeType(this, ErrorType::produce());
+	    ta->badIfCond(node->getCond()->line(), node->getCond()->col());
+	    ta->nodeType(node, TypeHandle::error());
 	}
 
-	for(auto stmt: *myBodyTrue){
-	    stmt->typeAnalysis(ta, nullptr);
+	for(auto stmt: node->getBodyTrue()){
+	    checkStmt(stmt, nullptr);
 	}
 
-	for(auto stmt: *myBodyFalse){
-	    stmt->typeAnalysis(ta, nullptr );
+	for(auto stmt: node->getBodyFalse()){
+	    checkStmt(stmt, nullptr);
 	}
 }
 
-void ReturnStmtNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
+void TypeChecker::visitReturn(ReturnStmtNode * node){
     // TODO case where return exp is of error type
     // do type analysis on the expression 
 	// an empty return stmt
-	if(myExp == nullptr){
-	    if(!retType->getType()->isVoid()){
+	TypeHandle ret = retType->getType()->handle();
+	if(node->getExp() == nullptr){
+	    if(!ret.isVoid()){
 		// throw an error return from non void with empty return
 		// set node to error type
-		ta->badNoRet(this->line(), this->col());
-		ta->nodeType(this, ErrorType::produce());
+		ta->badNoRet(node->line(), node->col());
+		ta->nodeType(node, TypeHandle::error());
 	    }
 	}
 	// type is void and we return something
-	else if(retType->getType()->isVoid()){
-	    myExp->typeAnalysis(ta);
-	    const DataType * exp = ta->nodeType(myExp);
-	    ta->extraRetValue(myExp->line(), myExp->col());
-	    ta->nodeType(this, ErrorType::produce());
+	else if(ret.isVoid()){
+	    visit(node->getExp());
+	    TypeHandle exp = ta->nodeType(node->getExp());
+	    ta->extraRetValue(node->getExp()->line(), node->getExp()->col());
+	    ta->nodeType(node, TypeHandle::error());
 	}
 	else {
-	    myExp->typeAnalysis(ta);
-	    const DataType * exp = ta->nodeType(myExp);
-	    if(exp->asError()!=nullptr){
-		ta->nodeType(this, ErrorType::produce());
+	    visit(node->getExp());
+	    TypeHandle exp = ta->nodeType(node->getExp());
+	    if(exp.isError()){
+		ta->nodeType(node, TypeHandle::error());
 	    }
 	    //type is not void but we return the wrong type
-	    else if(exp!=retType->getType()){
-		ta->badRetValue(myExp->line(), myExp->col());
-		ta->nodeType(this, ErrorType::produce());
+	    else if(exp!=ret){
+		ta->badRetValue(node->getExp()->line(), node->getExp()->col());
+		ta->nodeType(node, TypeHandle::error());
 	    }
 	    //types match
 	    else{
-		ta->nodeType(this, exp);
+		ta->nodeType(node, exp);
 	    }
 	}
 }
 
-void DerefNode::typeAnalysis(TypeAnalysis * ta){ //test
-	const DataType* id = ta->nodeType(myID);
+void TypeChecker::visitDeref(DerefNode * node){ //test
+	TypeHandle id = ta->nodeType(node->ID());
 	//error if dereferencing a function
-	if (id->asFn() != nullptr) {
-		ta->fnDeref(myID->line(), myID->col());
-		ta->nodeType(this, ErrorType::produce());
+	if (id.isFn()) {
+		ta->fnDeref(node->ID()->line(), node->ID()->col());
+		ta->nodeType(node, TypeHandle::error());
 	}
 	else {
-		ta->nodeType(this, id);
+		ta->nodeType(node, id);
 	}
 }
 
-void RefNode::typeAnalysis(TypeAnalysis * ta){ //test
-	const DataType* id = ta->nodeType(myID);	
-	ta->nodeType(this, id);
+void TypeChecker::visitRef(RefNode * node){ //test
+	TypeHandle id = ta->nodeType(node->ID());	
+	ta->nodeType(node, id);
 }
 
-void IndexNode::typeAnalysis(TypeAnalysis * ta){ //test
-	const DataType* base = ta->nodeType(myBase);
-	if (base->isPtr() == false) {
-		ta->badPtrBase(myBase->line(), myBase->col());
-		ta->nodeType(this, ErrorType::produce());
+void TypeChecker::visitIndex(IndexNode * node){ //test
+	TypeHandle base = ta->nodeType(node->getBase());
+	if (base.isPtr() == false) {
+		ta->badPtrBase(node->getBase()->line(), node->getBase()->col());
+		ta->nodeType(node, TypeHandle::error());
 	}
 	else {
-		myOffset->typeAnalysis(ta);
-		const DataType* offset = ta->nodeType(myOffset);
-		if (offset->isInt() == false) {
-			ta->badIndex(myBase->line(), myBase->col());
-			ta->nodeType(this, ErrorType::produce());
+		visit(node->getIndex());
+		TypeHandle offset = ta->nodeType(node->getIndex());
+		if (offset.isInt() == false) {
+			ta->badIndex(node->getBase()->line(), node->getBase()->col());
+			ta->nodeType(node, TypeHandle::error());
 		}
 		else {
-			ta->nodeType(this, offset);
+			ta->nodeType(node, offset);
 		}
 	}
 }
 
-void CallStmtNode::typeAnalysis(TypeAnalysis * ta, TypeNode * myRetType){
+void TypeChecker::visitCallStmt(CallStmtNode * node){
 	TODO("Implement me in the subclass");
 }
 
-void CallExpNode::typeAnalysis(TypeAnalysis * ta){
+void TypeChecker::visitCallExp(CallExpNode * node){
+    Span<ExpNode *> args = node->getArgs();
 
     // call typeAnalysis on id
-    myID->typeAnalysis(ta);
-    const DataType * id = ta->nodeType(myID);
+    visit(node->ID());
+    TypeHandle id = ta->nodeType(node->ID());
     // call to an id that is not a function id
-    if(id->asFn()==nullptr){
-	ta->badCallee(myID->line(),myID->col());
-	ta->nodeType(this, ErrorType::produce());
+    if(!id.isFn()){
+	ta->badCallee(node->ID()->line(),node->ID()->col());
+	ta->nodeType(node, TypeHandle::error());
 	return;
     }
+    const FnType * fn = id.asFn();
     // call type analysis on args
-	for(auto argument: *myArgs){
-	    argument->typeAnalysis(ta);
+	for(auto argument: args){
+	    visit(argument);
 	}
     // TODO check error type for arguments
     // wrong # of arguments
-    if(id->asFn()->getFormalTypes()->size()!=myArgs->size()){
-	ta->badArgCount(myID->line(),myID->col());
+    const std::vector<const DataType *>& formals = *fn->getFormalTypes();
+    if(formals.size()!=args.size()){
+	ta->badArgCount(node->ID()->line(),node->ID()->col());
     }
     // wrong argument types
     else{
-	int i=0;
-	int j=0;
-	if(id->asFn()->getFormalTypes()!=nullptr){
-	    auto it = id->asFn()->getFormalTypes()->begin();
-	    for(auto argument: *myArgs){
-		    while(j<i){
-			it++;
-			j++;
-		}
-		if(ta->nodeType(argument)->asError()!=nullptr){
-		}
-		else if(ta->nodeType(argument)!=*it ){
-		    ta->badArgMatch(argument->line(),argument->col());
-		}
-		    i++;
+	for(size_t i = 0; i < args.size(); i++){
+	    TypeHandle actual = ta->nodeType(args[i]);
+	    if(actual.isError()){
+	    }
+	    else if(actual!=formals[i]->handle()){
+		ta->badArgMatch(args[i]->line(),args[i]->col());
+	    }
 	}
-    }
-		ta->nodeType(this, id->asFn()->getReturnType());
+	ta->nodeType(node, fn->getReturnType()->handle());
     }
 }
 
-void FromConsoleStmtNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
+void TypeChecker::visitFromConsole(FromConsoleStmtNode * node){
     // call typeAnalysis on myDst
-    myDst->typeAnalysis(ta);
-    const DataType * dst = ta->nodeType(myDst);
+    visit(node->getDst());
+    TypeHandle dst = ta->nodeType(node->getDst());
     // myDst is a func
-    if(dst->asFn()!=nullptr){
-	ta->readFn(myDst->line(),myDst->col());
-	ta->nodeType(this, ErrorType::produce());
+    if(dst.isFn()){
+	ta->readFn(node->getDst()->line(),node->getDst()->col());
+	ta->nodeType(node, TypeHandle::error());
     }
     // it is a pointer
-    else if (dst->isPtr()){
-	ta->rawPtr(myDst->line(),myDst->col());
-	ta->nodeType(this, ErrorType::produce());
+    else if (dst.isPtr()){
+	ta->rawPtr(node->getDst()->line(),node->getDst()->col());
+	ta->nodeType(node, TypeHandle::error());
     }
     // TODO make sure that asBasic is correct
     else{
-	ta->nodeType(this, dst->asBasic());
+	ta->nodeType(node, dst.isBasic() ? dst : TypeHandle());
     }
 }
 
-void ToConsoleStmtNode::typeAnalysis(TypeAnalysis * ta, TypeNode * retType){
+void TypeChecker::visitToConsole(ToConsoleStmtNode * node){
     // call typeAnalysis on myDst
-    mySrc->typeAnalysis(ta);
-    const DataType * src = ta->nodeType(mySrc);
+    visit(node->getSrc());
+    TypeHandle src = ta->nodeType(node->getSrc());
     // myDst is a func
-    if(src->asFn()!=nullptr){
-	ta->writeFn(mySrc->line(),mySrc->col());
-	ta->nodeType(this, ErrorType::produce());
+    if(src.isFn()){
+	ta->writeFn(node->getSrc()->line(),node->getSrc()->col());
+	ta->nodeType(node, TypeHandle::error());
     }
     // it is a pointer
     // TODO allow charptr
-    else if (src->isPtr() && src->asPtr()->getString() != "charptr" ){
-	ta->rawPtr(mySrc->line(),mySrc->col());
-	ta->nodeType(this, ErrorType::produce());
+    else if (src.isPtr() && src != TypeHandle::ptr(CHAR, 1) ){
+	ta->rawPtr(node->getSrc()->line(),node->getSrc()->col());
+	ta->nodeType(node, TypeHandle::error());
     }
-    else if (src->isVoid()){
-	ta->badWriteVoid(mySrc->line(),mySrc->col());
-	ta->nodeType(this, ErrorType::produce());
+    else if (src.isVoid()){
+	ta->badWriteVoid(node->getSrc()->line(),node->getSrc()->col());
+	ta->nodeType(node, TypeHandle::error());
     }
     // TODO make sure that asBasic is correct
     else{
-	ta->nodeType(this, BasicType::produce(VOID));
+	ta->nodeType(node, TypeHandle::basic(VOID));
     }
 }
 
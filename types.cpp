@@ -1,5 +1,9 @@
+#include <atomic>
 #include <list>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "types.hpp"
 #include "ast.hpp"
@@ -25,27 +29,163 @@ std::string BasicType::getString() const{
 	return res;
 }
 
-DataType * CharTypeNode::getType() { 
-	BasicType * base = BasicType::CHAR();
-	if (isPtr){
-		return PtrType::produce(base, 1);
-	} else {
-		return base;
+//Pointer flyweights for the levels anyone is likely to use
+// live in a table indexed by base type and level. A slot is
+// filled the first time its type is asked for: every thread
+// that finds it empty builds a candidate, one of them wins
+// the compare-and-swap, and the others throw theirs away.
+// Deeper pointers fall back to a map under a lock.
+static const int PTR_TABLE_LEVELS = 16;
+static std::atomic<PtrType *> ptrFlyweights[4][PTR_TABLE_LEVELS];
+static std::mutex deepPtrLock;
+static HashMap<int, PtrType *> deepPtrs[4];
+
+PtrType * PtrType::produce(const BasicType * basicType, int level){
+	if (level <= 0){
+		throw new InternalError("bad pointer level");
+	}
+	BaseType base = basicType->getBaseType();
+
+	if (level > PTR_TABLE_LEVELS){
+		std::lock_guard<std::mutex> guard(deepPtrLock);
+		PtrType *& slot = deepPtrs[base][level];
+		if (slot == nullptr){
+			slot = new PtrType(basicType, level);
+		}
+		return slot;
+	}
+
+	std::atomic<PtrType *>& slot = ptrFlyweights[base][level - 1];
+	PtrType * fly = slot.load(std::memory_order_acquire);
+	if (fly != nullptr){
+		return fly;
+	}
+	PtrType * newType = new PtrType(basicType, level);
+	if (slot.compare_exchange_strong(fly, newType,
+	  std::memory_order_acq_rel)){
+		return newType;
 	}
+	delete newType;
+	return fly;
 }
 
-DataType * BoolTypeNode::getType() { 
-	BasicType * base = BasicType::BOOL();
-	if (isPtr){
-		return PtrType::produce(base, 1);
-	} else {
-		return base;
+//FnTypes are hash-consed on their signature: the handle of
+// the return type followed by the handles of the formals.
+// Function types are only produced at declarations, so the
+// table simply sits behind a lock.
+namespace{
+struct SignatureHash{
+	size_t operator()(const std::vector<TypeHandle>& sig) const {
+		size_t res = 14695981039346656037ull;
+		for (TypeHandle type : sig){
+			res = (res ^ type.bits()) * 1099511628211ull;
+		}
+		return res;
+	}
+};
+}
+
+static std::mutex fnTypesLock;
+static std::unordered_map<std::vector<TypeHandle>, FnType *, 
+	SignatureHash> fnTypes;
+
+FnType * FnType::produce(const std::vector<const DataType *>& formalsIn,
+  const DataType * retTypeIn){
+	std::vector<TypeHandle> sig;
+	sig.reserve(formalsIn.size() + 1);
+	sig.push_back(retTypeIn->handle());
+	for (const DataType * formal : formalsIn){
+		sig.push_back(formal->handle());
+	}
+
+	std::lock_guard<std::mutex> guard(fnTypesLock);
+	FnType *& fly = fnTypes[sig];
+	if (fly == nullptr){
+		fly = new FnType(formalsIn, retTypeIn);
 	}
+	return fly;
 }
 
-DataType * IntTypeNode::getType() { 
-	BasicType * base = BasicType::INT();
-	if (isPtr){
+//FnTypes are numbered in the order they are created. The
+// table is a fixed array of chunks that are allocated as
+// they fill and never move, so looking up an index needs
+// no lock even while other threads are adding types.
+static const uint32_t FN_CHUNK_BITS = 12;
+static const uint32_t FN_CHUNK_SIZE = 1u << FN_CHUNK_BITS;
+static const uint32_t FN_MAX_CHUNKS = 1u << 14;
+static std::atomic<const FnType **> fnChunks[FN_MAX_CHUNKS];
+static std::mutex fnLock;
+static uint32_t fnCount = 0;
+
+uint32_t FnType::registerType(const FnType * type){
+	std::lock_guard<std::mutex> guard(fnLock);
+	uint32_t index = fnCount;
+	uint32_t chunk = index >> FN_CHUNK_BITS;
+	if (chunk >= FN_MAX_CHUNKS){
+		throw new InternalError("too many function types");
+	}
+	const FnType ** entries = fnChunks[chunk].load(
+		std::memory_order_relaxed);
+	if (entries == nullptr){
+		entries = new const FnType *[FN_CHUNK_SIZE];
+	}
+	entries[index & (FN_CHUNK_SIZE - 1)] = type;
+	fnChunks[chunk].store(entries, std::memory_order_release);
+	fnCount++;
+	return index;
+}
+
+const FnType * FnType::byIndex(uint32_t index){
+	const FnType ** entries = fnChunks[index >> FN_CHUNK_BITS].load(
+		std::memory_order_acquire);
+	return entries[index & (FN_CHUNK_SIZE - 1)];
+}
+
+const FnType * TypeHandle::asFn() const {
+	if (!isFn()){ return nullptr; }
+	return FnType::byIndex(myBits >> 2);
+}
+
+const DataType * TypeHandle::type() const {
+	switch (tag()){
+	case TAG_ERROR:
+		return ErrorType::produce();
+	case TAG_FN:
+		return asFn();
+	case TAG_VAR:
+		if (isBasic()){
+			return BasicType::produce(getBaseType());
+		}
+		return PtrType::produce(BasicType::produce(getBaseType()), 
+			static_cast<int>(getLevel()));
+	}
+	return nullptr;
+}
+
+std::string TypeHandle::getString() const {
+	const DataType * res = type();
+	if (res == nullptr){ return "NONE"; }
+	return res->getString();
+}
+
+DataType * TypeNode::getType() { 
+	BasicType * base;
+	switch (kind()){
+	case NodeKind::VOID_TYPE:
+		return BasicType::VOID();
+	case NodeKind::INT_TYPE:
+		base = BasicType::INT();
+		break;
+	case NodeKind::BOOL_TYPE:
+		base = BasicType::BOOL();
+		break;
+	case NodeKind::CHAR_TYPE:
+		base = BasicType::CHAR();
+		break;
+	default:
+		throw new InternalError("Not a type node");
+	}
+	if (isPtr()){
 		return PtrType::produce(base, 1);
 	} else {
 		return base;
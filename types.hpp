@@ -1,8 +1,10 @@
 #ifndef XXLANG_DATA_TYPES
 #define XXLANG_DATA_TYPES
 
+#include <cstdint>
 #include <list>
 #include <sstream>
+#include <vector>
 #include "errors.hpp"
 
 #include <unordered_map>
@@ -19,6 +21,7 @@ namespace holeyc{
 
 class ASTNode;
 
+class DataType;
 class BasicType;
 class FnType;
 class PtrType;
@@ -28,6 +31,72 @@ enum BaseType{
 	INT, VOID, BOOL, CHAR
 };
 
+//A DataType packed into 32 bits, so that type analysis can
+// store, compare and query types without following a pointer
+// or making a virtual call. The low two bits give the kind of
+// type. Basic and pointer types keep their BaseType and
+// pointer level (0 for a basic type) in the bits above that,
+// and function types keep the index of their FnType. Since
+// basic and pointer types are flyweights and every FnType has
+// its own index, two handles are equal exactly when they
+// stand for the same DataType. The default handle stands for
+// no type at all.
+class TypeHandle{
+public:
+	TypeHandle() : myBits(TAG_NONE){ }
+
+	static TypeHandle error(){ return TypeHandle(TAG_ERROR); }
+	static TypeHandle basic(BaseType base){ return ptr(base, 0); }
+	static TypeHandle ptr(BaseType base, uint32_t level){
+		return TypeHandle(TAG_VAR 
+		  | static_cast<uint32_t>(base) << 2 | level << 4);
+	}
+	static TypeHandle fn(uint32_t index){
+		return TypeHandle(TAG_FN | index << 2);
+	}
+
+	bool isNone() const { return myBits == TAG_NONE; }
+	bool isError() const { return myBits == TAG_ERROR; }
+	bool isFn() const { return tag() == TAG_FN; }
+	bool isBasic() const { return (myBits & ~BASE_MASK) == TAG_VAR; }
+	bool isPtr() const { return tag() == TAG_VAR && !isBasic(); }
+	bool isInt() const { return *this == basic(INT); }
+	bool isBool() const { return *this == basic(BOOL); }
+	bool isVoid() const { return *this == basic(VOID); }
+	bool validVarType() const { return tag() == TAG_VAR && !isVoid(); }
+
+	//Only meaningful for basic and pointer types
+	BaseType getBaseType() const {
+		return static_cast<BaseType>((myBits & BASE_MASK) >> 2);
+	}
+	uint32_t getLevel() const { return myBits >> 4; }
+	//The raw encoding, for hashing
+	uint32_t bits() const { return myBits; }
+
+	//The FnType this handle stands for, or nullptr
+	const FnType * asFn() const;
+	//The DataType this handle stands for, or nullptr for the
+	// default handle
+	const DataType * type() const;
+	std::string getString() const;
+
+	bool operator==(TypeHandle other) const {
+		return myBits == other.myBits;
+	}
+	bool operator!=(TypeHandle other) const {
+		return myBits != other.myBits;
+	}
+private:
+	enum : uint32_t { 
+		TAG_NONE = 0, TAG_ERROR = 1, TAG_VAR = 2, TAG_FN = 3,
+		TAG_MASK = 3, BASE_MASK = 0xc
+	};
+	explicit TypeHandle(uint32_t bits) : myBits(bits){ }
+	uint32_t tag() const { return myBits & TAG_MASK; }
+
+	uint32_t myBits;
+};
+
 //This class is the superclass for all holeyc types. You
 // can get information about which type is implemented
 // concretely using the as<X> functions, or query information
@@ -44,7 +113,12 @@ public:
 	virtual bool isBool() const { return false; }
 	virtual bool isPtr() const { return false; }
 	virtual bool validVarType() const = 0 ;
+	//The packed form of this type
+	TypeHandle handle() const { return myHandle; }
 protected:
+	DataType(TypeHandle handleIn) : myHandle(handleIn){ }
+private:
+	TypeHandle myHandle;
 };
 
 //This DataType subclass is the superclass for all holeyc types. 
@@ -66,7 +140,7 @@ public:
 	}
 	virtual bool validVarType() const override { return false; }
 private:
-	ErrorType(){ 
+	ErrorType() : DataType(TypeHandle::error()){ 
 		/* private constructor, can only 
 		be called from produce */
 	}
@@ -97,7 +171,7 @@ public:
 	// and ensures that the memory needs of a program are kept
 	// down: rather than having a distinct type for every base
 	// INT (for example), only one is constructed and kept in
-	// the flyweights list. That type is then re-used anywhere
+	// the flyweights table. That type is then re-used anywhere
 	// it's needed. 
 
 	//Note the use of the static function declaration, which 
@@ -108,16 +182,19 @@ public:
 		//means that the flyweights variable persists between
 		// multiple calls to this function (it is essentially
 		// a global variable that can only be accessed
-		// in this function).
-		static std::list<BasicType *> flyweights;
-		for(BasicType * fly : flyweights){
-			if (fly->getBaseType() == base){
-				return fly;
-			}
-		}
-		BasicType * newType = new BasicType(base);
-		flyweights.push_back(newType);
-		return newType;
+		// in this function). There are only four BaseTypes,
+		// so every instance is made up front, and the table
+		// is an array indexed by the BaseType. The language
+		// guarantees the initialization happens exactly once
+		// even if several threads get here at the same time,
+		// and after that a lookup is a single load.
+		static BasicType * const flyweights[] = {
+			new BasicType(BaseType::INT), 
+			new BasicType(BaseType::VOID),
+			new BasicType(BaseType::BOOL), 
+			new BasicType(BaseType::CHAR)
+		};
+		return flyweights[base];
 	}
 	const BasicType * asVar() const {
 		return this;
@@ -141,34 +218,15 @@ public:
 	virtual std::string getString() const override;
 private:
 	BasicType(BaseType base) 
-	: myBaseType(base){ }
+	: DataType(TypeHandle::basic(base)), myBaseType(base){ }
 	BaseType myBaseType;
 };
 
-class PtrType : public DataType{
+class PtrType final : public DataType{
 public:
-	static PtrType * produce(const BasicType * basicType, int level){
-		if (level <= 0){
-			throw new InternalError("bad pointer level");
-		}
-
-		//Note the use of the static local variable, which
-		//means that the flyweights variable persists between
-		// multiple calls to this function (it is essentially
-		// a global variable that can only be accessed
-		// in this function).
-		static std::list<PtrType *> flyweights;
-		for(PtrType * fly : flyweights){
-			if (fly->myBasicType == basicType){
-				if (fly->myLevel == level){
-					return fly;
-				}
-			}
-		}
-		PtrType * newType = new PtrType(basicType, level);
-		flyweights.push_back(newType);
-		return newType;
-	}
+	//Produce the flyweight pointer type with the given base
+	// and level. Safe to call from several threads at once.
+	static PtrType * produce(const BasicType * basicType, int level);
 
 	std::string getString() const override{
 		std::string res = myBasicType->getString();
@@ -220,7 +278,9 @@ public:
 	
 private:
 	PtrType(const BasicType * basicType, int level)
-	: myBasicType(basicType), myLevel(level){
+	: DataType(TypeHandle::ptr(basicType->getBaseType(), 
+	    static_cast<uint32_t>(level))),
+	  myBasicType(basicType), myLevel(level){
 		/* private constructor, can only be called from produce */
 	}
 	const BasicType * myBasicType;
@@ -228,19 +288,23 @@ private:
 };
 
 //DataType subclass to represent the type of a function. It will
-// have a list of argument types and a return type. 
+// have a list of argument types and a return type. Function
+// types are hash-consed, like the other flyweights: there is
+// one FnType per signature, so two function types are the
+// same exactly when they are the same object (or have the
+// same handle).
 class FnType : public DataType{
 public:
-	FnType(const std::list<const DataType *>* formalsIn, const DataType * retTypeIn) 
-	: DataType(),
-	  myFormalTypes(formalsIn),
-	  myRetType(retTypeIn)
-	{
-	}
+	//Produce the function type with the given formal and
+	// return types. Safe to call from several threads at once.
+	static FnType * produce(
+		const std::vector<const DataType *>& formalsIn, 
+		const DataType * retTypeIn);
+
 	std::string getString() const override{
 		std::string result = "";
 		bool first = true;
-		for (auto elt : *myFormalTypes){
+		for (auto elt : myFormalTypes){
 			if (first) { first = false; }
 			else { result += ","; }
 			result += elt->getString();
@@ -254,12 +318,26 @@ public:
 	const DataType * getReturnType() const {
 		return myRetType;
 	}
-	const std::list<const DataType *> * getFormalTypes() const {
-		return myFormalTypes;
+	const std::vector<const DataType *> * getFormalTypes() const {
+		return &myFormalTypes;
 	}
 	virtual bool validVarType() const override { return false; }
+
+	//The FnType whose handle has the given index
+	static const FnType * byIndex(uint32_t index);
 private:
-	const std::list<const DataType *> * myFormalTypes;
+	FnType(const std::vector<const DataType *>& formalsIn, 
+	  const DataType * retTypeIn) 
+	: DataType(TypeHandle::fn(registerType(this))),
+	  myFormalTypes(formalsIn),
+	  myRetType(retTypeIn)
+	{
+	}
+
+	//Give a new FnType the next index
+	static uint32_t registerType(const FnType * type);
+
+	const std::vector<const DataType *> myFormalTypes;
 	const DataType * myRetType;
 };
 
@@ -1,360 +1,324 @@
 #include "ast.hpp"
+#include "ast_visitor.hpp"
 #include "errors.hpp"
 
 namespace holeyc{
 
-static void doIndent(std::ostream& out, int indent){
-	for (int k = 0 ; k < indent; k++){ out << "\t"; }
+static void doIndent(OutBuffer& out, int indent){
+	out.indent(indent);
 }
 
-void ProgramNode::unparse(std::ostream& out, int indent){
-	for (DeclNode * decl : *myGlobals){
-		decl->unparse(out, indent);
-	}
-}
-
-void VarDeclNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent); 
-	myType->unparse(out, 0);
-	out << " ";
-	myID->unparse(out, 0);
-	out << ";\n";
-}
-
-void FormalDeclNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent); 
-	getTypeNode()->unparse(out, 0);
-	out << " ";
-	ID()->unparse(out, 0);
-}
+namespace{
 
-void FnDeclNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent); 
-	myRetType->unparse(out, 0); 
-	out << " ";
-	myID->unparse(out, 0);
-	out << "(";
-	bool firstFormal = true;
-	for(auto formal : *myFormals){
-		if (firstFormal) { firstFormal = false; }
-		else { out << ", "; }
-		formal->unparse(out, 0);
-	}
-	out << "){\n";
-	for(auto stmt : *myBody){
-		stmt->unparse(out, indent+1);
-	}
-	doIndent(out, indent);
-	out << "}\n";
-}
-
-void AssignStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp->unparse(out,0);
-	out << ";\n";
-}
-
-void FromConsoleStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "FROMCONSOLE ";
-	myDst->unparse(out,0);
-	out << ";\n";
-}
+class Unparser : public ASTVisitor<Unparser>{
+public:
+	Unparser(OutBuffer& outIn, int indentIn)
+	: out(outIn), indent(indentIn){ }
 
-void ToConsoleStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "TOCONSOLE ";
-	mySrc->unparse(out,0);
-	out << ";\n";
-}
-
-void PostIncStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myLVal->unparse(out,0);
-	out << "++;\n";
-}
-
-void PostDecStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myLVal->unparse(out,0);
-	out << "--;\n";
-}
+	//Only statements and declarations start a line, so only
+	// they are indented; everything else is written inline
+	// where its parent puts it
+	void unparseAt(StmtNode * stmt, int indentIn){
+		int outer = indent;
+		indent = indentIn;
+		visit(stmt);
+		indent = outer;
+	}
 
-void IfStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "if (";
-	myCond->unparse(out, 0);
-	out << "){\n";
-	for (auto stmt : *myBody){
-		stmt->unparse(out, indent + 1);
+	//Lvalues and literals go without parentheses
+	void unparseNested(ExpNode * exp){
+		switch (exp->kind()){
+		case NodeKind::ID: case NodeKind::REF:
+		case NodeKind::DEREF: case NodeKind::INDEX:
+		case NodeKind::INT_LIT: case NodeKind::STR_LIT:
+		case NodeKind::CHAR_LIT: case NodeKind::NULLPTR_LIT:
+		case NodeKind::TRUE_LIT: case NodeKind::FALSE_LIT:
+			visit(exp);
+			return;
+		default:
+			out << "(";
+			visit(exp);
+			out << ")";
+		}
 	}
-	doIndent(out, indent);
-	out << "}\n";
-}
 
-void IfElseStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "if (";
-	myCond->unparse(out, 0);
-	out << "){\n";
-	for (auto stmt : *myBodyTrue){
-		stmt->unparse(out, indent + 1);
-	}
-	doIndent(out, indent);
-	out << "} else {\n";
-	for (auto stmt : *myBodyFalse){
-		stmt->unparse(out, indent + 1);
-	}
-	doIndent(out, indent);
-	out << "}\n";
-}
+	void visitProgram(ProgramNode * node){
+		for (DeclNode * decl : node->getGlobals()){
+			visit(decl);
+		}
+	}
 
-void WhileStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "while (";
-	myCond->unparse(out, 0);
-	out << "){\n";
-	for (auto stmt : *myBody){
-		stmt->unparse(out, indent + 1);
+	void visitVarDecl(VarDeclNode * node){
+		doIndent(out, indent); 
+		visit(node->getTypeNode());
+		out << " ";
+		visit(node->ID());
+		out << ";\n";
 	}
-	doIndent(out, indent);
-	out << "}\n";
-}
 
-void ReturnStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "return";
-	if (myExp != nullptr){
+	void visitFormalDecl(FormalDeclNode * node){
+		visit(node->getTypeNode());
 		out << " ";
-		myExp->unparse(out, 0);
+		visit(node->ID());
 	}
-	out << ";\n";
-}
 
-void CallStmtNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myCallExp->unparse(out, 0);
-	out << ";\n";
-}
+	void visitFnDecl(FnDeclNode * node){
+		doIndent(out, indent); 
+		visit(node->getRetTypeNode()); 
+		out << " ";
+		visit(node->ID());
+		out << "(";
+		bool firstFormal = true;
+		for(auto formal : node->getFormals()){
+			if (firstFormal) { firstFormal = false; }
+			else { out << ", "; }
+			visit(formal);
+		}
+		out << "){\n";
+		for(auto stmt : node->getBody()){
+			unparseAt(stmt, indent + 1);
+		}
+		doIndent(out, indent);
+		out << "}\n";
+	}
 
-void ExpNode::unparseNested(std::ostream& out){
-	out << "(";
-	unparse(out, 0);
-	out << ")";
-}
+	void visitAssignStmt(AssignStmtNode * node){
+		doIndent(out, indent);
+		visit(node->getExp());
+		out << ";\n";
+	}
 
-void CallExpNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myID->unparse(out, 0);
-	out << "(";
-	
-	bool firstArg = true;
-	for(auto arg : *myArgs){
-		if (firstArg) { firstArg = false; }
-		else { out << ", "; }
-		arg->unparse(out, 0);
-	}
-	out << ")";
-}
+	void visitFromConsole(FromConsoleStmtNode * node){
+		doIndent(out, indent);
+		out << "FROMCONSOLE ";
+		visit(node->getDst());
+		out << ";\n";
+	}
 
-void RefNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "^";
-	myID->unparseNested(out);
-}
+	void visitToConsole(ToConsoleStmtNode * node){
+		doIndent(out, indent);
+		out << "TOCONSOLE ";
+		visit(node->getSrc());
+		out << ";\n";
+	}
 
-void DerefNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "@";
-	myID->unparseNested(out);
-}
+	void visitPostInc(PostIncStmtNode * node){
+		doIndent(out, indent);
+		visit(node->getLVal());
+		out << "++;\n";
+	}
 
-void IndexNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myBase->unparseNested(out);
-	out << "[";
-	myOffset->unparse(out, 0);
-	out << "]";
-}
+	void visitPostDec(PostDecStmtNode * node){
+		doIndent(out, indent);
+		visit(node->getLVal());
+		out << "--;\n";
+	}
 
-void MinusNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp1->unparseNested(out); 
-	out << " - ";
-	myExp2->unparseNested(out);
-}
+	void visitIf(IfStmtNode * node){
+		doIndent(out, indent);
+		out << "if (";
+		visit(node->getCond());
+		out << "){\n";
+		for (auto stmt : node->getBody()){
+			unparseAt(stmt, indent + 1);
+		}
+		doIndent(out, indent);
+		out << "}\n";
+	}
 
-void PlusNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp1->unparseNested(out); 
-	out << " + ";
-	myExp2->unparseNested(out);
-}
+	void visitIfElse(IfElseStmtNode * node){
+		doIndent(out, indent);
+		out << "if (";
+		visit(node->getCond());
+		out << "){\n";
+		for (auto stmt : node->getBodyTrue()){
+			unparseAt(stmt, indent + 1);
+		}
+		doIndent(out, indent);
+		out << "} else {\n";
+		for (auto stmt : node->getBodyFalse()){
+			unparseAt(stmt, indent + 1);
+		}
+		doIndent(out, indent);
+		out << "}\n";
+	}
 
-void TimesNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp1->unparseNested(out); 
-	out << " * ";
-	myExp2->unparseNested(out);
-}
+	void visitWhile(WhileStmtNode * node){
+		doIndent(out, indent);
+		out << "while (";
+		visit(node->getCond());
+		out << "){\n";
+		for (auto stmt : node->getBody()){
+			unparseAt(stmt, indent + 1);
+		}
+		doIndent(out, indent);
+		out << "}\n";
+	}
 
-void DivideNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp1->unparseNested(out); 
-	out << " / ";
-	myExp2->unparseNested(out);
-}
+	void visitReturn(ReturnStmtNode * node){
+		doIndent(out, indent);
+		out << "return";
+		if (node->getExp() != nullptr){
+			out << " ";
+			visit(node->getExp());
+		}
+		out << ";\n";
+	}
 
-void AndNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp1->unparseNested(out); 
-	out << " && ";
-	myExp2->unparseNested(out);
-}
+	void visitCallStmt(CallStmtNode * node){
+		doIndent(out, indent);
+		visit(node->getCallExp());
+		out << ";\n";
+	}
 
-void OrNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp1->unparseNested(out); 
-	out << " || ";
-	myExp2->unparseNested(out);
-}
+	void visitCallExp(CallExpNode * node){
+		visit(node->ID());
+		out << "(";
+		
+		bool firstArg = true;
+		for(auto arg : node->getArgs()){
+			if (firstArg) { firstArg = false; }
+			else { out << ", "; }
+			visit(arg);
+		}
+		out << ")";
+	}
 
-void EqualsNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp1->unparseNested(out); 
-	out << " == ";
-	myExp2->unparseNested(out);
-}
+	void visitRef(RefNode * node){
+		out << "^";
+		unparseNested(node->ID());
+	}
 
-void NotEqualsNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp1->unparseNested(out); 
-	out << " != ";
-	myExp2->unparseNested(out);
-}
+	void visitDeref(DerefNode * node){
+		out << "@";
+		unparseNested(node->ID());
+	}
 
-void GreaterNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp1->unparseNested(out); 
-	out << " > ";
-	myExp2->unparseNested(out);
-}
+	void visitIndex(IndexNode * node){
+		unparseNested(node->getBase());
+		out << "[";
+		visit(node->getIndex());
+		out << "]";
+	}
 
-void GreaterEqNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp1->unparseNested(out); 
-	out << " >= ";
-	myExp2->unparseNested(out);
-}
+	void visitMinus(MinusNode * node){ binary(node, " - "); }
+	void visitPlus(PlusNode * node){ binary(node, " + "); }
+	void visitTimes(TimesNode * node){ binary(node, " * "); }
+	void visitDivide(DivideNode * node){ binary(node, " / "); }
+	void visitAnd(AndNode * node){ binary(node, " && "); }
+	void visitOr(OrNode * node){ binary(node, " || "); }
+	void visitEquals(EqualsNode * node){ binary(node, " == "); }
+	void visitNotEquals(NotEqualsNode * node){ binary(node, " != "); }
+	void visitGreater(GreaterNode * node){ binary(node, " > "); }
+	void visitGreaterEq(GreaterEqNode * node){ binary(node, " >= "); }
+	void visitLess(LessNode * node){ binary(node, " < "); }
+	void visitLessEq(LessEqNode * node){ binary(node, " <= "); }
+
+	void visitNot(NotNode * node){
+		out << "!";
+		unparseNested(node->getExp()); 
+	}
 
-void LessNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp1->unparseNested(out); 
-	out << " < ";
-	myExp2->unparseNested(out);
-}
+	void visitNeg(NegNode * node){
+		out << "-";
+		unparseNested(node->getExp()); 
+	}
 
-void LessEqNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myExp1->unparseNested(out); 
-	out << " <= ";
-	myExp2->unparseNested(out);
-}
+	void visitVoidType(VoidTypeNode *){
+		out << "void";
+	}
 
-void NotNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "!";
-	myExp->unparseNested(out); 
-}
+	void visitIntType(IntTypeNode * node){
+		if (node->isPtr()){
+			out << "intptr";
+		} else {
+			out << "int";
+		}
+	}
 
-void NegNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "-";
-	myExp->unparseNested(out); 
-}
+	void visitBoolType(BoolTypeNode * node){
+		if (node->isPtr()){
+			out << "boolptr";
+		} else {
+			out << "bool";
+		}
+	}
 
-void VoidTypeNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "void";
-}
+	void visitCharType(CharTypeNode * node){
+		if (node->isPtr()){
+			out << "charptr";
+		} else {
+			out << "char";
+		}
+	}
 
-void IntTypeNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	if (this->isPtr){
-		out << "intptr";
-	} else {
-		out << "int";
+	void visitAssignExp(AssignExpNode * node){
+		unparseNested(node->getDst());
+		out << " = ";
+		unparseNested(node->getSrc());
 	}
-}
 
-void BoolTypeNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	if (this->isPtr){
-		out << "boolptr";
-	} else {
-		out << "bool";
+	void visitID(IDNode * node){
+		out << node->getName();
 	}
-}
 
-void CharTypeNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	if (this->isPtr){
-		out << "charptr";
-	} else {
-		out << "char";
+	void visitIntLit(IntLitNode * node){
+		out << node->getNum();
 	}
-}
 
-void AssignExpNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	myDst->unparseNested(out);
-	out << " = ";
-	mySrc->unparseNested(out);
-}
+	void visitCharLit(CharLitNode * node){
+		char val = node->getVal();
+		if (val == '\n'){
+			out << "'\\n";
+		} else if (val == '\t'){
+			out << "'\\t";
+		} else {
+			out << "'" << val;
+		}
+	}
 
-void LValNode::unparseNested(std::ostream& out){
-	unparse(out, 0);
-}
+	void visitStrLit(StrLitNode * node){
+		out.put(node->getStr(), node->getLen());
+	}
 
-void IDNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << name;
-}
+	void visitNullPtr(NullPtrNode *){
+		out << "NULLPTR";
+	}
 
-void IntLitNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << myNum;
-}
+	void visitFalse(FalseNode *){
+		out << "false";
+	}
 
-void CharLitNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	if (myVal == '\n'){
-		out << "'\\n";
-	} else if (myVal == '\t'){
-		out << "'\\t";
-	} else {
-		out << "'" << myVal;
+	void visitTrue(TrueNode *){
+		out << "true";
+	}
+private:
+	//op is a literal, so its length is known here
+	template <size_t N>
+	void binary(BinaryExpNode * node, const char (&op)[N]){
+		unparseNested(node->getExp1()); 
+		out.put(op, N - 1);
+		unparseNested(node->getExp2());
 	}
-}
 
-void StrLitNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << myStr;
-}
+	OutBuffer& out;
+	int indent;
+};
 
-void NullPtrNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "NULLPTR";
 }
 
-void FalseNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "false";
+void ASTNode::unparse(OutBuffer& out, int indent){
+	if (kind() > NodeKind::CALL_STMT || kind() == NodeKind::FORMAL_DECL){
+		//Written as if it began a line
+		doIndent(out, indent);
+	}
+	Unparser(out, indent).visit(this);
 }
 
-void TrueNode::unparse(std::ostream& out, int indent){
-	doIndent(out, indent);
-	out << "true";
+void StreamingUnparser::emit(DeclNode * decl){
+	Unparser(myOut, 0).visit(decl);
+	//Nothing refers to the declaration once it is written
+	myArena->rewind(myMark);
 }
 
 } //End namespace holeyc
@@ -0,0 +1,64 @@
+#include <thread>
+
+#include "work_stealing_pool.hpp"
+
+namespace holeyc{
+
+WorkStealingPool::WorkStealingPool(size_t numThreads)
+: myNumThreads(numThreads == 0 ? 1 : numThreads){
+	for (size_t i = 0; i < myNumThreads; i++){
+		myWorkers.push_back(std::unique_ptr<Worker>(new Worker()));
+	}
+}
+
+void WorkStealingPool::run(size_t count,
+  const std::function<void(size_t)>& task){
+	//Deal the tasks out round-robin. No tasks are added once
+	// the workers start, so a worker that finds every deque
+	// empty knows it is done.
+	for (size_t i = 0; i < count; i++){
+		myWorkers[i % myNumThreads]->tasks.push_back(i);
+	}
+
+	std::vector<std::thread> threads;
+	for (size_t w = 1; w < myNumThreads && w < count; w++){
+		threads.push_back(std::thread(
+			&WorkStealingPool::work, this, w, std::cref(task)));
+	}
+	work(0, task);
+	for (std::thread& thread : threads){
+		thread.join();
+	}
+}
+
+void WorkStealingPool::work(size_t self,
+  const std::function<void(size_t)>& task){
+	size_t index;
+	while (take(self, index)){
+		task(index);
+	}
+}
+
+bool WorkStealingPool::take(size_t self, size_t& index){
+	{
+		Worker& own = *myWorkers[self];
+		std::lock_guard<std::mutex> guard(own.lock);
+		if (!own.tasks.empty()){
+			index = own.tasks.back();
+			own.tasks.pop_back();
+			return true;
+		}
+	}
+	for (size_t k = 1; k < myNumThreads; k++){
+		Worker& victim = *myWorkers[(self + k) % myNumThreads];
+		std::lock_guard<std::mutex> guard(victim.lock);
+		if (!victim.tasks.empty()){
+			index = victim.tasks.front();
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+}
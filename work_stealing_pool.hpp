@@ -0,0 +1,42 @@
+#ifndef HOLEYC_WORK_STEALING_POOL_HPP
+#define HOLEYC_WORK_STEALING_POOL_HPP
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace holeyc{
+
+//Runs a batch of independent tasks, numbered 0 to count-1, on
+// a fixed number of threads. Each worker starts with its own
+// deque holding an even share of the tasks. It takes work from
+// the back of its own deque, and once that runs dry it steals
+// from the front of the others'. A worker that draws a few
+// large tasks therefore doesn't leave the rest of its share
+// waiting while the other workers sit idle.
+class WorkStealingPool{
+public:
+	WorkStealingPool(size_t numThreads);
+
+	//Run task(i) for every i in [0, count), using the calling
+	// thread as one of the workers, and return once all of
+	// them have finished
+	void run(size_t count, const std::function<void(size_t)>& task);
+	size_t size() const { return myNumThreads; }
+private:
+	struct Worker{
+		std::mutex lock;
+		std::deque<size_t> tasks;
+	};
+	void work(size_t self, const std::function<void(size_t)>& task);
+	bool take(size_t self, size_t& index);
+
+	size_t myNumThreads;
+	std::vector<std::unique_ptr<Worker>> myWorkers;
+};
+
+}
+
+#endif